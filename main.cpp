@@ -8,17 +8,57 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <bitset>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
 #include <cstdint>
+#include <cstdlib>
 #include <ctime>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <print>
+#include <semaphore>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#endif
+
 #include <SDL.h>
 #include <SDL_image.h>
 
@@ -30,24 +70,183 @@ constexpr const char
     *VERSION      = "v0.2.1",
     *RELEASE_DATE = "04/09/2026";
 
-namespace rng {
+enum class HugePages : std::uint8_t {
+    Off,
+    Transparent,
+    Explicit
+};
+
+constexpr std::array<std::string_view, 3> HUGE_PAGES_NAMES{ "off", "transparent", "explicit" };
+
+enum class UpdateMode : std::uint8_t {
+    // Every pass updates the tiles in place in scan order
+    Sequential,
+    // Moves and births read one buffer and write the other, so no tile's update depends on the
+    // order tiles are visited in
+    Synchronous
+};
+
+constexpr std::array<std::string_view, 2> UPDATE_MODE_NAMES{ "sequential", "synchronous" };
+
+enum class NumaPlacement : std::uint8_t {
+    Off,
+    // Each node gets a band of columns, its memory and threads pinned to it
+    Partition
+};
+
+constexpr std::array<std::string_view, 2> NUMA_PLACEMENT_NAMES{ "off", "partition" };
+
+enum class DomainTransportType : std::uint8_t {
+    SharedMemory,
+    Socket
+};
+
+constexpr std::array<std::string_view, 2> DOMAIN_TRANSPORT_NAMES{ "shm", "socket" };
+
+enum class RngDraws : std::uint8_t {
+    // Bounded draws take the remainder, drawing the same numbers as ever for a seed
+    Compat,
+    // Bounded draws scale the word by the bound with a multiply and a shift, no division
+    Fast
+};
+
+constexpr std::array<std::string_view, 2> RNG_DRAWS_NAMES{ "compat", "fast" };
+
+struct Options {
+    HugePages huge_pages = HugePages::Transparent;
+    UpdateMode update_mode = UpdateMode::Sequential;
+    NumaPlacement numa_placement = NumaPlacement::Off;
+    RngDraws rng_draws = RngDraws::Compat;
+    std::string world_file, rules_file;
+    // Headless ensemble mode, enabled by a nonzero run count
+    std::uint32_t ensemble_runs = 0, ensemble_gens = 1000, threads = 0;
+    std::uint16_t world_w = 256, world_h = 256;
+    std::optional<std::uint32_t> seed, stats_interval;
+    std::string stats_file = "stats.csv";
+    // Sweep mode, enabled by a sweep spec file, or run as one of its workers
+    std::string sweep_file, sweep_dir = "sweep";
+    bool is_sweep_worker = false;
+    std::uint32_t sweep_seeds = 8;
+    std::string executable;
+    // Lineage log to write, or to query along with an optional cell to trace
+    std::string lineage_file, lineage_query_file;
+    std::optional<std::uint64_t> ancestors_of, descendants_of;
+    // Headless frame export, enabled by an output directory
+    std::string frames_dir;
+    std::uint32_t frame_interval = 1, frame_tile = 4, encoder_threads = 0;
+    // GIF, or raw RGB24 video for any other extension, recorded whenever the sim view opens
+    std::string record_file;
+    // Shared-memory name to publish every generation to
+    std::string stream_name;
+    // Runs without the window, controlled over a Unix domain socket at this path
+    std::string control_socket;
+    // Domain decomposition, enabled by a grid of domains each run by a worker process, or run as
+    // the worker of one of them
+    std::uint16_t domain_cols = 0, domain_rows = 0;
+    DomainTransportType domain_transport = DomainTransportType::SharedMemory;
+    std::optional<std::uint32_t> domain_rank;
+};
+
+Options options;
+
+struct Rng {
+    static constexpr std::uint32_t INCREMENT = 0x9E3779B9, TILE_STATE_BLOCK = 16;
     std::uint32_t state, seed;
     void srand(std::uint32_t new_seed) noexcept {
         state = seed = new_seed;
     }
+    static std::uint32_t mix(std::uint32_t value) noexcept {
+        value = (value ^ (value >> 16)) * 0x85EBCA6B;
+        value = (value ^ (value >> 13)) * 0xC2B2AE35;
+        return value ^ (value >> 16);
+    }
+    // A word below max
+    static std::uint32_t bound(std::uint32_t word, std::uint32_t max) noexcept {
+        return options.rng_draws == RngDraws::Fast ?
+            static_cast<std::uint32_t>(static_cast<std::uint64_t>(word) * max >> 32) :
+            word % max;
+    }
+    // What the streams of every tile in one phase of a generation start from
+    static std::uint32_t get_phase_key(
+        std::uint32_t seed,
+        std::uint32_t gen,
+        std::uint8_t phase
+    ) noexcept {
+        return mix(mix(seed ^ phase) ^ gen);
+    }
+    // A stream of its own for one tile in one phase of a generation, drawing the same numbers
+    // whatever order the tiles are visited in
+    static Rng for_tile(std::uint32_t seed, std::uint32_t phase_key, std::uint32_t i) noexcept {
+        return { .state = mix(phase_key ^ i), .seed = seed };
+    }
+    static Rng for_tile(
+        std::uint32_t seed,
+        std::uint32_t gen,
+        std::uint32_t i,
+        std::uint8_t phase
+    ) noexcept {
+        return for_tile(seed, get_phase_key(seed, gen, phase), i);
+    }
+    // States of the streams of a block of consecutive tiles. The block has a fixed size so the
+    // compiler vectorizes the loop at -O2 too.
+    static void fill_tile_states(
+        std::uint32_t phase_key,
+        std::uint32_t first_i,
+        std::array<std::uint32_t, TILE_STATE_BLOCK> &states
+    ) noexcept {
+        for (std::uint32_t j = 0; j < TILE_STATE_BLOCK; ++j) {
+            states[j] = mix(phase_key ^ (first_i + j));
+        }
+    }
     std::uint32_t rand() noexcept {
-        std::uint32_t output = (state += 0x9E3779B9);
-        output = (output ^ (output >> 16)) * 0x85EBCA6B;
-        output = (output ^ (output >> 13)) * 0xC2B2AE35;
-        return output ^ (output >> 16);
+        return mix(state += INCREMENT);
     }
     std::uint32_t rand(std::uint32_t max) noexcept {
-        return rand() % max;
+        return bound(rand(), max);
     }
     bool chance(std::uint32_t denominator) noexcept {
-        return rand() % denominator == 0;
+        return bound(rand(), denominator) == 0;
     }
-}
+};
+
+// Draws from a stream a batch of words ahead, hashing each batch in a loop the compiler
+// vectorizes. The words are the ones the stream itself would have drawn, and the stream catches up
+// with however many were drawn once the batch is gone, so no one else may draw from it meanwhile.
+class RngBatch {
+    static constexpr std::uint32_t SIZE = 64;
+    Rng &rng;
+    // The stream's state before the batch, and the next word of the batch
+    std::uint32_t state, next;
+    std::array<std::uint32_t, SIZE> words;
+    void fill() noexcept {
+        for (std::uint32_t j = 0; j < SIZE; ++j) {
+            words[j] = Rng::mix(state + (j + 1) * Rng::INCREMENT);
+        }
+        next = 0;
+    }
+public:
+    explicit RngBatch(Rng &new_rng) noexcept : rng{ new_rng }, state{ new_rng.state } {
+        fill();
+    }
+    ~RngBatch() {
+        rng.state = state + next * Rng::INCREMENT;
+    }
+    RngBatch(const RngBatch &) = delete;
+    RngBatch &operator=(const RngBatch &) = delete;
+    std::uint32_t rand() noexcept {
+        if (next == SIZE) {
+            state += SIZE * Rng::INCREMENT;
+            fill();
+        }
+        return words[next++];
+    }
+    std::uint32_t rand(std::uint32_t max) noexcept {
+        return Rng::bound(rand(), max);
+    }
+    bool chance(std::uint32_t denominator) noexcept {
+        return Rng::bound(rand(), denominator) == 0;
+    }
+};
 
 constexpr std::int32_t
     WINDOW_WIDTH      = 1280,
@@ -75,38 +274,128 @@ constexpr struct nk_color
     COLOR_BORDER    { .r = 0xC8, .g = 0x00, .b = 0x5A, .a = 0xFF },
     COLOR_CUSTOM_QOL{ .r = 0x39, .g = 0xFF, .b = 0x14, .a = 0xFF };
 
+class RenderBatch {
+    SDL_Texture *texture;
+    float texture_w, texture_h;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<std::int32_t> indices;
+    void push_quad(
+        const SDL_Rect &dstrect,
+        const SDL_Color &color,
+        float u0, float v0, float u1, float v1
+    ) {
+        const std::int32_t base = vertices.size();
+        const float
+            x0 = dstrect.x, y0 = dstrect.y,
+            x1 = dstrect.x + dstrect.w, y1 = dstrect.y + dstrect.h;
+        vertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+        vertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+        vertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+        vertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+        indices.insert(
+            indices.end(),
+            { base, base + 1, base + 2, base, base + 2, base + 3 }
+        );
+    }
+public:
+    RenderBatch() :
+        texture{ nullptr },
+        texture_w{ 1 },
+        texture_h{ 1 },
+        vertices{},
+        indices{}
+    {}
+    void bind(SDL_Texture *new_texture, std::int32_t w, std::int32_t h) {
+        texture = new_texture;
+        texture_w = w;
+        texture_h = h;
+    }
+    void push(const SDL_Rect &dstrect, const SDL_Color &color) {
+        push_quad(dstrect, color, 0, 0, 0, 0);
+    }
+    void push(const SDL_Rect &srcrect, const SDL_Rect &dstrect) {
+        push_quad(
+            dstrect,
+            { .r = 0xFF, .g = 0xFF, .b = 0xFF, .a = 0xFF },
+            srcrect.x / texture_w,
+            srcrect.y / texture_h,
+            (srcrect.x + srcrect.w) / texture_w,
+            (srcrect.y + srcrect.h) / texture_h
+        );
+    }
+    bool flush(SDL_Renderer *renderer) {
+        if (indices.empty()) {
+            return true;
+        }
+        const bool is_rendered = SDL_RenderGeometry(
+            renderer,
+            texture,
+            vertices.data(),
+            vertices.size(),
+            indices.data(),
+            indices.size()
+        ) == 0;
+        vertices.clear();
+        indices.clear();
+        return is_rendered;
+    }
+};
+
 class Context {
     bool is_inited;
 public:
     SDL_Window *window;
+    // Only set when rendering offscreen
+    SDL_Surface *surface;
     SDL_Renderer *renderer;
     struct nk_context *nk_ctx;
-    SDL_Texture *texture;
+    SDL_Texture *texture, *overview_texture, *heatmap_texture, *record_texture;
+    std::array<SDL_Texture *, 2> background_textures;
     struct nk_font *font;
     struct nk_font_atlas *font_atlas;
     std::array<struct nk_image, 8> icons;
+    // Drawn rather than loaded, since the texture has no icon for it. Shows either the record or
+    // the stop icon of record_icons.
+    std::array<struct nk_image, 2> record_icons;
+    struct nk_image record_icon;
     struct nk_style_button misc_style_button_disabled;
+    RenderBatch tint_batch, sprite_batch;
+    std::int32_t overview_texture_w, overview_texture_h;
     std::int32_t window_w, window_h, scroll_x, scroll_y;
     Context() :
         is_inited{ false },
         window{ nullptr },
+        surface{ nullptr },
         renderer{ nullptr },
         nk_ctx{ nullptr },
         texture{ nullptr },
+        overview_texture{ nullptr },
+        heatmap_texture{ nullptr },
+        record_texture{ nullptr },
+        background_textures{},
         font{ nullptr },
         font_atlas{ nullptr },
         icons{},
+        record_icons{},
+        record_icon{},
         misc_style_button_disabled{},
+        tint_batch{},
+        sprite_batch{},
+        overview_texture_w{ 0 },
+        overview_texture_h{ 0 },
         window_w{ 0 },
         window_h{ 0 },
         scroll_x{ 0 },
         scroll_y{ 0 }
-    {
+    {}
+    // Opens the window and loads the assets. Kept out of the constructor so that headless modes
+    // never touch SDL
+    bool init() {
         if (
             SDL_Init(SDL_INIT_VIDEO) != 0 ||
             !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)
         ) {
-            return;
+            return false;
         }
         window = SDL_CreateWindow(
             TITLE,
@@ -117,7 +406,7 @@ public:
             SDL_WINDOW_RESIZABLE
         );
         if (!window) {
-            return;
+            return false;
         }
         SDL_SetWindowMinimumSize(window, MIN_WINDOW_WIDTH, MIN_WINDOW_HEIGHT);
         renderer = SDL_CreateRenderer(
@@ -126,19 +415,13 @@ public:
             SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
         );
         if (!renderer) {
-            return;
+            return false;
         }
         SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
         nk_ctx = nk_sdl_init(window, renderer);
-        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "best");
-        SDL_Surface *surface = IMG_Load(TEXTURE_PATH);
-        if (!surface) {
-            return;
-        }
-        texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
-        if (!texture) {
-            return;
+        std::int32_t texture_w, texture_h;
+        if (!load_texture(texture_w, texture_h)) {
+            return false;
         }
         nk_sdl_font_stash_begin(&font_atlas);
         font = nk_font_atlas_add_from_file(
@@ -149,13 +432,9 @@ public:
         );
         nk_sdl_font_stash_end();
         if (!font) {
-            return;
+            return false;
         }
         nk_style_set_font(nk_ctx, &font->handle);
-        std::int32_t texture_w, texture_h;
-        if (SDL_QueryTexture(texture, nullptr, nullptr, &texture_w, &texture_h) != 0) {
-            return;
-        }
         for (std::uint8_t i = 0; i < icons.size(); ++i) {
             icons[i] = nk_subimage_ptr(
                 texture,
@@ -169,6 +448,9 @@ public:
                 )
             );
         }
+        if (!create_record_icons()) {
+            return false;
+        }
         nk_ctx->style.window.fixed_background.data.color = nk_rgba_u32(0);
         nk_ctx->style.window.padding = nk_vec2(0, 0);
         nk_ctx->style.text.color = COLOR_FG;
@@ -199,12 +481,123 @@ public:
         misc_style_button_disabled.hover.data.color = COLOR_TRIGGER;
         misc_style_button_disabled.active.data.color = COLOR_TRIGGER;
         is_inited = true;
+        return true;
+    }
+    // Renders into a surface with the software renderer instead, for exporting frames without a
+    // window or a GPU
+    bool init_offscreen(std::int32_t w, std::int32_t h) {
+        if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+            return false;
+        }
+        is_inited = true;
+        window_w = w;
+        window_h = h;
+        surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!surface) {
+            return false;
+        }
+        renderer = SDL_CreateSoftwareRenderer(surface);
+        if (!renderer) {
+            return false;
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        return load_texture();
+    }
+    // A circle to start recording and a square to stop it, side by side
+    bool create_record_icons() {
+        SDL_Surface *icons_surface = SDL_CreateRGBSurfaceWithFormat(
+            0, 2 * ICON_WIDTH, ICON_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888
+        );
+        if (!icons_surface) {
+            return false;
+        }
+        const std::uint32_t color =
+            0xFF000000 |
+            static_cast<std::uint32_t>(COLOR_FG.r) << 16 |
+            static_cast<std::uint32_t>(COLOR_FG.g) << 8 |
+            COLOR_FG.b;
+        for (std::int32_t y = 0; y < ICON_HEIGHT; ++y) {
+            std::uint32_t *row = reinterpret_cast<std::uint32_t *>(
+                static_cast<std::uint8_t *>(icons_surface->pixels) + y * icons_surface->pitch
+            );
+            for (std::int32_t x = 0; x < ICON_WIDTH; ++x) {
+                const std::int32_t dx = 2 * x + 1 - ICON_WIDTH, dy = 2 * y + 1 - ICON_HEIGHT;
+                row[x] = dx * dx + dy * dy <= 14 * 14 ? color : 0;
+                row[ICON_WIDTH + x] =
+                    std::abs(dx) <= 11 && std::abs(dy) <= 11 ? color : 0;
+            }
+        }
+        record_texture = SDL_CreateTextureFromSurface(renderer, icons_surface);
+        SDL_FreeSurface(icons_surface);
+        if (!record_texture) {
+            return false;
+        }
+        for (std::uint8_t i = 0; i < record_icons.size(); ++i) {
+            record_icons[i] = nk_subimage_ptr(
+                record_texture,
+                2 * ICON_WIDTH,
+                ICON_HEIGHT,
+                nk_rect(i * ICON_WIDTH, 0, ICON_WIDTH, ICON_HEIGHT)
+            );
+        }
+        record_icon = record_icons[0];
+        return true;
+    }
+    // For callers that don't need the size of the sprite sheet
+    bool load_texture() {
+        std::int32_t texture_w = 0, texture_h = 0;
+        return load_texture(texture_w, texture_h);
+    }
+    bool load_texture(std::int32_t &texture_w, std::int32_t &texture_h) {
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "best");
+        SDL_Surface *surface = IMG_Load(TEXTURE_PATH);
+        if (!surface) {
+            return false;
+        }
+        texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_FreeSurface(surface);
+        if (
+            !texture ||
+            SDL_QueryTexture(texture, nullptr, nullptr, &texture_w, &texture_h) != 0
+        ) {
+            return false;
+        }
+        sprite_batch.bind(texture, texture_w, texture_h);
+        return true;
     }
     ~Context() noexcept {
         if (!is_inited) {
             return;
         }
+        if (!window) {
+            if (texture) {
+                SDL_DestroyTexture(texture);
+            }
+            if (renderer) {
+                SDL_DestroyRenderer(renderer);
+            }
+            if (surface) {
+                SDL_FreeSurface(surface);
+            }
+            IMG_Quit();
+            SDL_Quit();
+            return;
+        }
         nk_font_atlas_cleanup(font_atlas);
+        if (overview_texture) {
+            SDL_DestroyTexture(overview_texture);
+        }
+        if (heatmap_texture) {
+            SDL_DestroyTexture(heatmap_texture);
+        }
+        if (record_texture) {
+            SDL_DestroyTexture(record_texture);
+        }
+        for (SDL_Texture *background_texture : background_textures) {
+            if (background_texture) {
+                SDL_DestroyTexture(background_texture);
+            }
+        }
         SDL_DestroyTexture(texture);
         nk_sdl_shutdown();
         SDL_DestroyRenderer(renderer);
@@ -212,12 +605,75 @@ public:
         IMG_Quit();
         SDL_Quit();
     }
-    operator bool() const {
-        return is_inited;
-    }
     bool render(SDL_Rect &srcrect, SDL_Rect &dstrect) {
         return SDL_RenderCopy(renderer, texture, &srcrect, &dstrect) == 0;
     }
+    void batch(const SDL_Rect &srcrect, const SDL_Rect &dstrect) {
+        sprite_batch.push(srcrect, dstrect);
+    }
+    void batch(const SDL_Rect &dstrect, const SDL_Color &color) {
+        tint_batch.push(dstrect, color);
+    }
+    bool flush() {
+        return tint_batch.flush(renderer) && sprite_batch.flush(renderer);
+    }
+    bool reserve_overview(std::int32_t w, std::int32_t h) {
+        if (overview_texture && w <= overview_texture_w && h <= overview_texture_h) {
+            return true;
+        }
+        if (overview_texture) {
+            SDL_DestroyTexture(overview_texture);
+        }
+        overview_texture_w = std::max(w, overview_texture_w);
+        overview_texture_h = std::max(h, overview_texture_h);
+        overview_texture = SDL_CreateTexture(
+            renderer,
+            SDL_PIXELFORMAT_ARGB8888,
+            SDL_TEXTUREACCESS_STREAMING,
+            overview_texture_w,
+            overview_texture_h
+        );
+        return
+            overview_texture &&
+            SDL_SetTextureScaleMode(overview_texture, SDL_ScaleModeNearest) == 0;
+    }
+    bool create_background(std::int32_t w, std::int32_t h) {
+        for (SDL_Texture *&background_texture : background_textures) {
+            if (background_texture) {
+                SDL_DestroyTexture(background_texture);
+            }
+            background_texture = SDL_CreateTexture(
+                renderer,
+                SDL_PIXELFORMAT_ARGB8888,
+                SDL_TEXTUREACCESS_TARGET,
+                w,
+                h
+            );
+            if (
+                !background_texture ||
+                SDL_SetTextureBlendMode(background_texture, SDL_BLENDMODE_NONE) != 0
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool create_heatmap(std::int32_t w, std::int32_t h) {
+        if (heatmap_texture) {
+            SDL_DestroyTexture(heatmap_texture);
+        }
+        heatmap_texture = SDL_CreateTexture(
+            renderer,
+            SDL_PIXELFORMAT_ARGB8888,
+            SDL_TEXTUREACCESS_STREAMING,
+            w,
+            h
+        );
+        return
+            heatmap_texture &&
+            SDL_SetTextureScaleMode(heatmap_texture, SDL_ScaleModeNearest) == 0 &&
+            SDL_SetTextureBlendMode(heatmap_texture, SDL_BLENDMODE_BLEND) == 0;
+    }
 };
 
 Context ctx;
@@ -452,6 +908,8 @@ namespace gui {
         PANEL_ELEMENT_OUTLINE = 2;
     extern GUITextElement text_mul, text_zoom, text_speed;
     extern GUIPanelElement panel_controls;
+    extern GUIButtonElement btn_turbo;
+    extern GUIInputElement input_run_to;
     GUITextElement
         text_world_size{
             UXState::Creation,
@@ -526,7 +984,7 @@ namespace gui {
                 return nk_rect(
                     6 * ELEMENT_MARGIN + 5 * ICON_BUTTON_ELEMENT_WIDTH,
                     3 * ELEMENT_MARGIN / 2,
-                    60,
+                    80,
                     TEXT_ELEMENT_HEIGHT
                 );
             },
@@ -630,6 +1088,36 @@ namespace gui {
             },
             NK_TEXT_ALIGN_LEFT
         },
+        text_jump{
+            UXState::Sim,
+            []() -> struct nk_rect {
+                const struct nk_rect panel_controls_rect = panel_controls.pos();
+                return nk_rect(
+                    ctx.window_w - ELEMENT_MARGIN - 140,
+                    panel_controls_rect.y + panel_controls_rect.h +
+                    ELEMENT_MARGIN,
+                    140,
+                    TEXT_ELEMENT_HEIGHT
+                );
+            },
+            NK_TEXT_ALIGN_LEFT,
+            "Jump to:"
+        },
+        text_heatmap{
+            UXState::Sim,
+            []() -> struct nk_rect {
+                const struct nk_rect panel_controls_rect = panel_controls.pos();
+                return nk_rect(
+                    ctx.window_w - ELEMENT_MARGIN - 140,
+                    panel_controls_rect.y + panel_controls_rect.h + ELEMENT_MARGIN +
+                    TEXT_ELEMENT_HEIGHT + 5 * (ICON_BUTTON_ELEMENT_HEIGHT + ELEMENT_MARGIN),
+                    140,
+                    TEXT_ELEMENT_HEIGHT
+                );
+            },
+            NK_TEXT_ALIGN_LEFT,
+            "Heatmap:"
+        },
         text_report_world_size{
             UXState::Sim,
             []() -> struct nk_rect {
@@ -748,6 +1236,20 @@ namespace gui {
             },
             10,
             nk_filter_decimal
+        },
+        input_run_to{
+            UXState::Sim,
+            []() -> struct nk_rect {
+                const struct nk_rect btn_turbo_rect = btn_turbo.pos();
+                return nk_rect(
+                    btn_turbo_rect.x + btn_turbo_rect.w + ELEMENT_MARGIN,
+                    ELEMENT_MARGIN,
+                    120,
+                    ICON_BUTTON_ELEMENT_HEIGHT
+                );
+            },
+            10,
+            nk_filter_decimal
         };
     GUIButtonElement btn_generate{
         UXState::Creation,
@@ -761,6 +1263,131 @@ namespace gui {
             );
         },
         "Generate"
+    },
+    btn_cancel{
+        UXState::Generation,
+        []() -> struct nk_rect {
+            return nk_rect(
+                ctx.window_w / 2 - 100,
+                ctx.window_h / 2 + TEXT_ELEMENT_HEIGHT / 2 + 2 * ELEMENT_MARGIN,
+                200,
+                BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Cancel"
+    },
+    btn_turbo{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect
+                text_zoom_rect = text_zoom.pos(),
+                text_speed_rect = text_speed.pos();
+            return nk_rect(
+                13 * ELEMENT_MARGIN + 9 * ICON_BUTTON_ELEMENT_WIDTH +
+                text_zoom_rect.w + text_speed_rect.w,
+                ELEMENT_MARGIN,
+                80,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Turbo"
+    },
+    btn_run_to{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect input_run_to_rect = input_run_to.pos();
+            return nk_rect(
+                input_run_to_rect.x + input_run_to_rect.w + ELEMENT_MARGIN,
+                ELEMENT_MARGIN,
+                80,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Run to"
+    },
+    btn_jump_oldest{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect panel_controls_rect = panel_controls.pos();
+            return nk_rect(
+                ctx.window_w - ELEMENT_MARGIN - 140,
+                panel_controls_rect.y + panel_controls_rect.h + ELEMENT_MARGIN +
+                TEXT_ELEMENT_HEIGHT,
+                140,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Oldest cell"
+    },
+    btn_jump_richest{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect panel_controls_rect = panel_controls.pos();
+            return nk_rect(
+                ctx.window_w - ELEMENT_MARGIN - 140,
+                panel_controls_rect.y + panel_controls_rect.h + 2 * ELEMENT_MARGIN +
+                TEXT_ELEMENT_HEIGHT + ICON_BUTTON_ELEMENT_HEIGHT,
+                140,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Richest chunk"
+    },
+    btn_jump_motility{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect panel_controls_rect = panel_controls.pos();
+            return nk_rect(
+                ctx.window_w - ELEMENT_MARGIN - 140,
+                panel_controls_rect.y + panel_controls_rect.h + ELEMENT_MARGIN +
+                TEXT_ELEMENT_HEIGHT + 2 * (ICON_BUTTON_ELEMENT_HEIGHT + ELEMENT_MARGIN),
+                140,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Motility"
+    },
+    btn_jump_polydivision{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect panel_controls_rect = panel_controls.pos();
+            return nk_rect(
+                ctx.window_w - ELEMENT_MARGIN - 140,
+                panel_controls_rect.y + panel_controls_rect.h + ELEMENT_MARGIN +
+                TEXT_ELEMENT_HEIGHT + 3 * (ICON_BUTTON_ELEMENT_HEIGHT + ELEMENT_MARGIN),
+                140,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Polydivision"
+    },
+    btn_jump_energosynthesis{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect panel_controls_rect = panel_controls.pos();
+            return nk_rect(
+                ctx.window_w - ELEMENT_MARGIN - 140,
+                panel_controls_rect.y + panel_controls_rect.h + ELEMENT_MARGIN +
+                TEXT_ELEMENT_HEIGHT + 4 * (ICON_BUTTON_ELEMENT_HEIGHT + ELEMENT_MARGIN),
+                140,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Energosynthesis"
+    },
+    btn_heatmap{
+        UXState::Sim,
+        []() -> struct nk_rect {
+            const struct nk_rect panel_controls_rect = panel_controls.pos();
+            return nk_rect(
+                ctx.window_w - ELEMENT_MARGIN - 140,
+                panel_controls_rect.y + panel_controls_rect.h + ELEMENT_MARGIN +
+                2 * TEXT_ELEMENT_HEIGHT + 5 * (ICON_BUTTON_ELEMENT_HEIGHT + ELEMENT_MARGIN),
+                140,
+                ICON_BUTTON_ELEMENT_HEIGHT
+            );
+        },
+        "Off"
     };
     GUIIconButtonElement
         icon_btn_start{
@@ -799,6 +1426,18 @@ namespace gui {
             },
             ctx.icons[2]
         },
+        icon_btn_record{
+            UXState::Sim,
+            []() -> struct nk_rect {
+                return nk_rect(
+                    4 * ELEMENT_MARGIN + 3 * ICON_BUTTON_ELEMENT_WIDTH,
+                    ELEMENT_MARGIN,
+                    ICON_BUTTON_ELEMENT_WIDTH,
+                    ICON_BUTTON_ELEMENT_HEIGHT
+                );
+            },
+            ctx.record_icon
+        },
         icon_btn_zoom_in{
             UXState::Sim,
             []() -> struct nk_rect {
@@ -880,7 +1519,7 @@ namespace gui {
             );
         }
     };
-    std::array<std::reference_wrapper<GUIElement>, 32> elements{{
+    std::array<std::reference_wrapper<GUIElement>, 45> elements{{
         text_world_size,
         text_seed,
         text_mul,
@@ -890,16 +1529,21 @@ namespace gui {
         btn_generate,
         text_error,
         text_generating,
+        btn_cancel,
         panel_controls,
         icon_btn_start,
         icon_btn_stop,
         icon_btn_step,
+        icon_btn_record,
         icon_btn_zoom_in,
         icon_btn_zoom_out,
         text_zoom,
         icon_btn_speed_up,
         icon_btn_slow_down,
         text_speed,
+        btn_turbo,
+        input_run_to,
+        btn_run_to,
         icon_btn_quit,
         text_report_ptr_pos,
         text_report_curr_tile_energy,
@@ -907,6 +1551,14 @@ namespace gui {
         text_report_curr_cell_energy,
         text_report_curr_cell_undergone_evolutions,
         text_report_curr_cell_ongoing_evolution,
+        text_jump,
+        btn_jump_oldest,
+        btn_jump_richest,
+        btn_jump_motility,
+        btn_jump_polydivision,
+        btn_jump_energosynthesis,
+        text_heatmap,
+        btn_heatmap,
         text_report_world_size,
         text_report_seed,
         text_report_gen,
@@ -986,9 +1638,10 @@ struct Evolution {
         Energosynthesis,
         COUNT
     };
-    std::string name;
+    std::string_view name;
     std::uint32_t eligibility, cost, timescale;
     std::uint16_t acq_prob, loss_prob;
+    bool operator==(const Evolution &) const = default;
 };
 
 constexpr std::array<Evolution, 3> EVOLUTIONS{{
@@ -1020,11 +1673,184 @@ constexpr std::array<Evolution, 3> EVOLUTIONS{{
 
 using EvolutionInfo = Info<EVOLUTIONS.size()>;
 
-struct Cell {
-    std::uint32_t age, energy;
-    const Evolution *ongoing_evolution;
-    std::uint32_t ongoing_evolution_progress;
-    EvolutionInfo undergone_evolutions, utilized_evolutions;
+struct Rules {
+    std::array<Evolution, Evolution::COUNT> evolutions = EVOLUTIONS;
+    std::uint8_t enabled_evolutions = (1 << Evolution::COUNT) - 1;
+    std::uint32_t
+        energy_tick_interval = 10,
+        harvest_tile_energy_low = 50,
+        harvest_tile_energy_high = 100,
+        harvest_age_low = 20,
+        harvest_age_high = 40,
+        living_cost_age_step = 100,
+        reproduction_min_age = 10,
+        reproduction_min_energy = 10,
+        polydivision_min_energy = 20,
+        reproduction_odds = 8,
+        polydivision_odds = 16,
+        generation_cell_odds = 10;
+    bool operator==(const Rules &) const = default;
+};
+
+constexpr Rules DEFAULT_RULES{};
+
+Rules rules;
+
+// The advance kernels read their parameters through this, so the default rule set folds into
+// constants exactly like the hard-coded rules did
+template <bool is_default>
+const Rules &get_rules() noexcept {
+    if constexpr (is_default) {
+        return DEFAULT_RULES;
+    } else {
+        return rules;
+    }
+}
+
+constexpr bool is_evolution_enabled(std::uint8_t enabled_evolutions, std::uint8_t i) noexcept {
+    return enabled_evolutions >> i & 1;
+}
+
+// Lowercase form of a display name, used in config keys and stats columns
+std::string get_key(std::string_view name) {
+    std::string key(name);
+    std::transform(key.begin(), key.end(), key.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    return key;
+}
+
+std::string_view trim(std::string_view str) noexcept {
+    const std::size_t begin = str.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    return str.substr(begin, str.find_last_not_of(" \t\r") - begin + 1);
+}
+
+template <typename T>
+bool parse_number(std::string_view str, T &number) noexcept {
+    const auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), number);
+    return !str.empty() && error == std::errc{} && end == str.data() + str.size();
+}
+
+// Evolution parameters are keyed by the lowercase evolution name, e.g. "motility.cost" or
+// "polydivision.enabled"
+bool set_rule(Rules &target, std::string_view key, std::uint32_t value) {
+    const std::array<std::pair<std::string_view, std::uint32_t Rules::*>, 12> RULE_KEYS{{
+        { "energy_tick_interval", &Rules::energy_tick_interval },
+        { "harvest_tile_energy_low", &Rules::harvest_tile_energy_low },
+        { "harvest_tile_energy_high", &Rules::harvest_tile_energy_high },
+        { "harvest_age_low", &Rules::harvest_age_low },
+        { "harvest_age_high", &Rules::harvest_age_high },
+        { "living_cost_age_step", &Rules::living_cost_age_step },
+        { "reproduction_min_age", &Rules::reproduction_min_age },
+        { "reproduction_min_energy", &Rules::reproduction_min_energy },
+        { "polydivision_min_energy", &Rules::polydivision_min_energy },
+        { "reproduction_odds", &Rules::reproduction_odds },
+        { "polydivision_odds", &Rules::polydivision_odds },
+        { "generation_cell_odds", &Rules::generation_cell_odds }
+    }};
+    for (const auto &[rule_key, member] : RULE_KEYS) {
+        if (key == rule_key) {
+            target.*member = value;
+            return true;
+        }
+    }
+    for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+        const std::string prefix = get_key(target.evolutions[i].name) + '.';
+        if (!key.starts_with(prefix)) {
+            continue;
+        }
+        const std::string_view field = key.substr(prefix.size());
+        Evolution &evolution = target.evolutions[i];
+        if (field == "enabled") {
+            target.enabled_evolutions = value ?
+                target.enabled_evolutions | 1 << i :
+                target.enabled_evolutions & ~(1 << i);
+        } else if (field == "eligibility") {
+            evolution.eligibility = value;
+        } else if (field == "cost") {
+            evolution.cost = value;
+        } else if (field == "timescale") {
+            evolution.timescale = value;
+        } else if (field == "acq_prob" && value <= std::numeric_limits<std::uint16_t>::max()) {
+            evolution.acq_prob = value;
+        } else if (field == "loss_prob" && value <= std::numeric_limits<std::uint16_t>::max()) {
+            evolution.loss_prob = value;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Intervals, odds and timescales divide or are divided by, so none of them can be 0
+bool is_valid_rules(const Rules &target) noexcept {
+    bool is_valid =
+        target.energy_tick_interval != 0 &&
+        target.living_cost_age_step != 0 &&
+        target.reproduction_odds != 0 &&
+        target.polydivision_odds != 0 &&
+        target.generation_cell_odds != 0;
+    for (const Evolution &evolution : target.evolutions) {
+        is_valid =
+            is_valid &&
+            evolution.timescale != 0 &&
+            evolution.acq_prob != 0 &&
+            evolution.loss_prob != 0;
+    }
+    return is_valid;
+}
+
+// Reads "key = value" lines, with "#" comments, over the current rules
+bool load_rules(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::println(std::cerr, "[Rules error] Couldn't open {}", path);
+        return false;
+    }
+    std::string line;
+    for (std::uint32_t line_number = 1; std::getline(file, line); ++line_number) {
+        const std::string_view content = trim(std::string_view(line).substr(0, line.find('#')));
+        if (content.empty()) {
+            continue;
+        }
+        const std::size_t separator = content.find('=');
+        const std::string_view key = trim(content.substr(0, separator));
+        std::uint32_t value;
+        if (
+            separator == std::string_view::npos ||
+            !parse_number(trim(content.substr(separator + 1)), value)
+        ) {
+            std::println(std::cerr, "[Rules error] {}:{}: expected key = number", path, line_number);
+            return false;
+        }
+        if (!set_rule(rules, key, value)) {
+            std::println(std::cerr, "[Rules error] {}:{}: unknown rule {}", path, line_number, key);
+            return false;
+        }
+    }
+    if (!is_valid_rules(rules)) {
+        std::println(std::cerr, "[Rules error] {}: intervals, odds and timescales can't be 0", path);
+        return false;
+    }
+    return true;
+}
+
+struct Cell {
+    // Unique within a world, kept when moving and never reused, 0 for no cell
+    std::uint64_t id;
+    std::uint32_t age, energy;
+    // Index into the evolutions plus one, or zero if none, so tiles hold no pointers and can be
+    // mapped from a file
+    std::uint8_t ongoing_evolution;
+    std::uint32_t ongoing_evolution_progress;
+    EvolutionInfo undergone_evolutions, utilized_evolutions;
+    const Evolution &get_ongoing_evolution() const noexcept {
+        return rules.evolutions[ongoing_evolution - 1];
+    }
 };
 
 namespace Event {
@@ -1071,185 +1897,1362 @@ struct Tile {
     Cell cell;
 };
 
+namespace memory {
+    constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    void *map_zeroed(std::size_t &size, HugePages huge_pages) noexcept {
+#ifdef _WIN32
+        static_cast<void>(huge_pages);
+        return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        void *ptr;
+#ifdef MAP_HUGETLB
+        if (huge_pages == HugePages::Explicit) {
+            const std::size_t huge_size =
+                (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            ptr = mmap(
+                nullptr,
+                huge_size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                -1,
+                0
+            );
+            if (ptr != MAP_FAILED) {
+                size = huge_size;
+                return ptr;
+            }
+            std::println(
+                std::cerr,
+                "[Memory warning] Couldn't map {} bytes of explicit huge pages, "
+                "falling back to transparent huge pages",
+                huge_size
+            );
+        }
+#endif
+        ptr = mmap(
+            nullptr,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0
+        );
+        if (ptr == MAP_FAILED) {
+            return nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        if (huge_pages != HugePages::Off) {
+            madvise(ptr, size, MADV_HUGEPAGE);
+        }
+#endif
+        return ptr;
+#endif
+    }
+    void unmap(void *ptr, std::size_t size) noexcept {
+#ifdef _WIN32
+        static_cast<void>(size);
+        VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+        munmap(ptr, size);
+#endif
+    }
+    // Maps a file shared and read-write. When size is nonzero the file is (re)created sparse
+    // with that size, otherwise the existing file is mapped whole and size receives its length
+    void *map_file(const std::string &path, std::size_t &size) noexcept {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ | GENERIC_WRITE,
+            0,
+            nullptr,
+            size ? CREATE_ALWAYS : OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        LARGE_INTEGER file_size;
+        if (size) {
+            file_size.QuadPart = size;
+        } else if (GetFileSizeEx(file, &file_size)) {
+            size = file_size.QuadPart;
+        }
+        void *ptr = nullptr;
+        HANDLE mapping = size ? CreateFileMappingA(
+            file, nullptr, PAGE_READWRITE, file_size.HighPart, file_size.LowPart, nullptr
+        ) : nullptr;
+        if (mapping) {
+            ptr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return ptr;
+#else
+        const std::int32_t fd =
+            open(path.c_str(), size ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+        if (fd == -1) {
+            return nullptr;
+        }
+        struct stat file_stat;
+        if (size ? ftruncate(fd, size) == -1 : fstat(fd, &file_stat) == -1) {
+            close(fd);
+            return nullptr;
+        }
+        if (!size) {
+            size = file_stat.st_size;
+        }
+        void *ptr = size ?
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            return nullptr;
+        }
+        // Every pass sweeps the tilemap front to back, so let the kernel read ahead and drop
+        // pages behind the sweep when the world doesn't fit in memory
+        madvise(ptr, size, MADV_SEQUENTIAL);
+        return ptr;
+#endif
+    }
+    void unmap_file(void *ptr, std::size_t size) noexcept {
+#ifdef _WIN32
+        FlushViewOfFile(ptr, size);
+        UnmapViewOfFile(ptr);
+#else
+        msync(ptr, size, MS_SYNC);
+        munmap(ptr, size);
+#endif
+    }
+}
+
+// Node topology and placement, only available on Linux. Elsewhere the world is one node.
+namespace numa {
+    // Nodes beyond this many are left alone
+    constexpr std::uint32_t MAX_NODES = 1024;
+    struct Node {
+        std::uint32_t id;
+        // Only the CPUs this process is allowed to run on
+        std::vector<std::uint32_t> cpus;
+    };
+    // Parses a kernel CPU list, e.g. "0-3,8-11"
+    std::vector<std::uint32_t> parse_cpu_list(std::string_view list) {
+        std::vector<std::uint32_t> cpus;
+        while (!list.empty()) {
+            const std::size_t separator = list.find(',');
+            const std::string_view range = list.substr(0, separator);
+            const std::size_t dash = range.find('-');
+            std::uint32_t first = 0, last = 0;
+            const std::string_view first_text = range.substr(0, dash);
+            if (
+                std::from_chars(first_text.data(), first_text.data() + first_text.size(), first)
+                    .ec != std::errc{}
+            ) {
+                return {};
+            }
+            last = first;
+            if (dash != std::string_view::npos) {
+                const std::string_view last_text = range.substr(dash + 1);
+                if (
+                    std::from_chars(last_text.data(), last_text.data() + last_text.size(), last)
+                        .ec != std::errc{}
+                ) {
+                    return {};
+                }
+            }
+            for (std::uint32_t cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+            list = separator == std::string_view::npos ? "" : list.substr(separator + 1);
+        }
+        return cpus;
+    }
+    // The nodes with CPUs this process may use, by id
+    std::vector<Node> find_nodes() {
+        std::vector<Node> nodes;
+#ifdef __linux__
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return nodes;
+        }
+        std::error_code error;
+        for (
+            const std::filesystem::directory_entry &entry :
+            std::filesystem::directory_iterator("/sys/devices/system/node", error)
+        ) {
+            const std::string name = entry.path().filename().string();
+            Node node{};
+            if (
+                !name.starts_with("node") ||
+                std::from_chars(name.data() + 4, name.data() + name.size(), node.id).ec !=
+                    std::errc{} ||
+                node.id >= MAX_NODES
+            ) {
+                continue;
+            }
+            std::ifstream file(entry.path() / "cpulist");
+            std::string list;
+            std::getline(file, list);
+            for (const std::uint32_t cpu : parse_cpu_list(list)) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                    node.cpus.push_back(cpu);
+                }
+            }
+            if (!node.cpus.empty()) {
+                nodes.push_back(std::move(node));
+            }
+        }
+        std::ranges::sort(nodes, {}, &Node::id);
+#endif
+        return nodes;
+    }
+    // Restricts the calling thread to the CPUs of a node
+    bool pin_thread(const Node &node) noexcept {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (const std::uint32_t cpu : node.cpus) {
+            CPU_SET(cpu, &cpus);
+        }
+        return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+        static_cast<void>(node);
+        return false;
+#endif
+    }
+    // Prefers a node for the whole pages of a range, moving the pages already touched
+    bool bind(void *ptr, std::size_t size, std::uint32_t node) noexcept {
+#ifdef __linux__
+        constexpr std::uintptr_t PAGE_SIZE = 4096;
+        constexpr std::uint64_t MPOL_PREFERRED = 1, MPOL_MF_MOVE = 1 << 1;
+        const std::uintptr_t
+            begin = (reinterpret_cast<std::uintptr_t>(ptr) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1),
+            end = (reinterpret_cast<std::uintptr_t>(ptr) + size) & ~(PAGE_SIZE - 1);
+        if (begin >= end) {
+            return true;
+        }
+        constexpr std::uint32_t MASK_BITS = std::numeric_limits<unsigned long>::digits;
+        std::array<unsigned long, MAX_NODES / MASK_BITS> mask{};
+        mask[node / MASK_BITS] = 1ul << node % MASK_BITS;
+        // The kernel reads one bit less than it's told
+        return syscall(
+            SYS_mbind,
+            begin,
+            end - begin,
+            MPOL_PREFERRED,
+            mask.data(),
+            MAX_NODES + 1,
+            MPOL_MF_MOVE
+        ) == 0;
+#else
+        static_cast<void>(ptr);
+        static_cast<void>(size);
+        static_cast<void>(node);
+        return false;
+#endif
+    }
+}
+
+enum class WorldFileState : std::uint32_t {
+    Updating,
+    Ready
+};
+
+struct alignas(64) WorldFileHeader {
+    static constexpr std::array<char, 8> MAGIC{ 'E', 'V', 'O', 'W', 'O', 'R', 'L', 'D' };
+    static constexpr std::uint32_t VERSION = 2;
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    WorldFileState state;
+    std::uint16_t w, h;
+    std::uint32_t gen, seed, rng_state;
+    std::uint32_t tile_size;
+    std::uint64_t next_cell_id;
+};
+
+static_assert(std::is_trivially_copyable_v<Tile>);
+
+enum class LineageEvent : std::uint8_t {
+    Birth,
+    Death,
+    Evolutions
+};
+
+// Births carry the parent, and every record carries the cell's undergone evolutions after it
+struct LineageRecord {
+    std::uint64_t cell_id, parent_id;
+    std::uint32_t gen;
+    LineageEvent event;
+    std::uint8_t evolutions;
+};
+
+static_assert(sizeof(LineageRecord) == 24);
+
+struct LineageFileHeader {
+    static constexpr std::array<char, 8> MAGIC{ 'E', 'V', 'O', 'L', 'I', 'N', 'E', 'A' };
+    static constexpr std::uint32_t VERSION = 1;
+    std::array<char, 8> magic;
+    std::uint32_t version, record_size;
+};
+
+// Records go to a fixed arena allocated up front and written out whole when it fills up, so
+// logging never allocates while advancing
+class LineageLog {
+    static constexpr std::uint32_t CAPACITY = 1 << 16;
+    std::unique_ptr<LineageRecord[]> records;
+    std::uint32_t count;
+    std::ofstream file;
+public:
+    LineageLog() : records{}, count{ 0 }, file{} {}
+    ~LineageLog() {
+        close();
+    }
+    bool open(const std::string &path, bool is_appending) {
+        close();
+        if (!records) {
+            records = std::make_unique<LineageRecord[]>(CAPACITY);
+        }
+        file.open(path, std::ios::binary | (is_appending ? std::ios::app : std::ios::trunc));
+        if (!file) {
+            return false;
+        }
+        if (!is_appending || file.tellp() == 0) {
+            const LineageFileHeader header{
+                .magic = LineageFileHeader::MAGIC,
+                .version = LineageFileHeader::VERSION,
+                .record_size = sizeof(LineageRecord)
+            };
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
+        return static_cast<bool>(file);
+    }
+    void append(const LineageRecord &record) {
+        records[count] = record;
+        if (++count == CAPACITY) {
+            flush();
+        }
+    }
+    void flush() {
+        file.write(
+            reinterpret_cast<const char *>(records.get()),
+            static_cast<std::streamsize>(count) * sizeof(LineageRecord)
+        );
+        file.flush();
+        count = 0;
+    }
+    void close() {
+        if (file.is_open()) {
+            flush();
+            file.close();
+        }
+    }
+};
+
+// A rectangle of tiles, the ends excluded
+struct TileRegion {
+    std::uint16_t x_begin, x_end, y_begin, y_end;
+    TileRegion intersect(const TileRegion &other) const noexcept {
+        return {
+            std::max(x_begin, other.x_begin),
+            std::min(x_end, other.x_end),
+            std::max(y_begin, other.y_begin),
+            std::min(y_end, other.y_end)
+        };
+    }
+    TileRegion grow(std::uint16_t margin, const TileRegion &bounds) const noexcept {
+        return TileRegion{
+            static_cast<std::uint16_t>(std::max(x_begin - margin, 0)),
+            static_cast<std::uint16_t>(std::min(x_end + margin, 0xFFFF)),
+            static_cast<std::uint16_t>(std::max(y_begin - margin, 0)),
+            static_cast<std::uint16_t>(std::min(y_end + margin, 0xFFFF))
+        }.intersect(bounds);
+    }
+    bool operator==(const TileRegion &other) const noexcept = default;
+};
+
+class ChunkIndex;
+
+class StateStream;
+
+class AdvanceScheduler;
+
+class Domain;
+
+// Tiles are stored column by column, matching the x-then-y order of every pass over the world,
+// so that each pass streams through memory (and the world file) front to back
 struct World {
     std::uint32_t gen;
     std::uint16_t w, h;
     std::uint32_t size;
+    std::size_t mapping_size;
+    WorldFileHeader *header;
     Tile *tilemap, *ptr;
+    // Only allocated in the synchronous update mode: a second tilemap followed by a byte per tile
+    // for the move and birth intents
+    Tile *back_tilemap;
+    std::uint8_t *intents;
+    std::size_t back_mapping_size;
+    Rng rng;
+    std::uint64_t next_cell_id;
+    // Optional, births, deaths and evolution changes are only recorded when set
+    LineageLog *lineage;
+    // Optional, kept up to date by the advance passes when set
+    ChunkIndex *index;
+    // Optional, every generation is published to it when set
+    StateStream *stream;
+    // Optional, the synchronous passes are spread over its threads when set
+    AdvanceScheduler *scheduler;
+    // Where this world sits in the whole world when it's only a domain of it, halo included
+    std::uint16_t origin_x, origin_y, full_h;
+    TileRegion interior;
+    Domain *domain;
     Tile &operator[](std::uint16_t x, std::uint16_t y) noexcept {
-        return tilemap[y * static_cast<std::uint32_t>(w) + x];
+        return tilemap[x * static_cast<std::uint32_t>(h) + y];
     }
-    bool create(std::uint16_t new_w, std::uint16_t new_h) noexcept {
+    bool create(
+        std::uint16_t new_w,
+        std::uint16_t new_h,
+        HugePages huge_pages,
+        const std::string &file
+    ) noexcept {
         w = new_w;
         h = new_h;
         size = static_cast<std::uint32_t>(w) * h;
-        try {
-            tilemap = new Tile[w * h]{};
+        set_whole();
+        if (file.empty()) {
+            mapping_size = sizeof(Tile) * size;
+            tilemap = static_cast<Tile *>(memory::map_zeroed(mapping_size, huge_pages));
+            if (!tilemap || !create_back_tilemap(huge_pages)) {
+                destroy();
+                return false;
+            }
+            return true;
+        }
+        mapping_size = sizeof(WorldFileHeader) + sizeof(Tile) * size;
+        header = static_cast<WorldFileHeader *>(memory::map_file(file, mapping_size));
+        if (!header) {
+            return false;
+        }
+        header->magic = WorldFileHeader::MAGIC;
+        header->version = WorldFileHeader::VERSION;
+        header->state = WorldFileState::Updating;
+        header->w = w;
+        header->h = h;
+        header->tile_size = sizeof(Tile);
+        tilemap = reinterpret_cast<Tile *>(header + 1);
+        if (!create_back_tilemap(huge_pages)) {
+            destroy();
+            return false;
+        }
+        return true;
+    }
+    // Maps a world file left behind by a previous run and restores its generation and RNG
+    bool open(const std::string &file) noexcept {
+        mapping_size = 0;
+        header = static_cast<WorldFileHeader *>(memory::map_file(file, mapping_size));
+        if (!header) {
+            std::println(std::cerr, "[World file error] Couldn't map {}", file);
+            return false;
+        }
+        if (
+            mapping_size < sizeof(WorldFileHeader) ||
+            header->magic != WorldFileHeader::MAGIC ||
+            header->version != WorldFileHeader::VERSION ||
+            header->tile_size != sizeof(Tile) ||
+            mapping_size !=
+                sizeof(WorldFileHeader) +
+                sizeof(Tile) * static_cast<std::uint32_t>(header->w) * header->h
+        ) {
+            std::println(std::cerr, "[World file error] {} isn't a compatible world file", file);
+            destroy();
+            return false;
+        }
+        if (header->state != WorldFileState::Ready) {
+            std::println(
+                std::cerr,
+                "[World file error] {} was left mid-update and can't be resumed",
+                file
+            );
+            destroy();
+            return false;
+        }
+        gen = header->gen;
+        w = header->w;
+        h = header->h;
+        size = static_cast<std::uint32_t>(w) * h;
+        set_whole();
+        tilemap = reinterpret_cast<Tile *>(header + 1);
+        if (!create_back_tilemap(options.huge_pages)) {
+            std::println(std::cerr, "[World file error] Out of memory for the second tilemap");
+            destroy();
+            return false;
+        }
+        rng.seed = header->seed;
+        rng.state = header->rng_state;
+        next_cell_id = header->next_cell_id;
+        return true;
+    }
+    void set_whole() noexcept {
+        origin_x = 0;
+        origin_y = 0;
+        full_h = h;
+        interior = get_region();
+    }
+    bool create_back_tilemap(HugePages huge_pages) noexcept {
+        if (options.update_mode != UpdateMode::Synchronous) {
             return true;
-        } catch (const std::bad_alloc &) {
+        }
+        back_mapping_size = (sizeof(Tile) + sizeof(std::uint8_t)) * size;
+        back_tilemap = static_cast<Tile *>(memory::map_zeroed(back_mapping_size, huge_pages));
+        if (!back_tilemap) {
             return false;
         }
+        intents = reinterpret_cast<std::uint8_t *>(back_tilemap + size);
+        return true;
+    }
+    // A world file is only resumable between updates, when the tiles, the generation and the
+    // RNG agree with each other
+    void begin_update() noexcept {
+        if (header) {
+            header->state = WorldFileState::Updating;
+        }
+    }
+    void end_update() noexcept {
+        if (header) {
+            header->gen = gen;
+            header->seed = rng.seed;
+            header->rng_state = rng.state;
+            header->next_cell_id = next_cell_id;
+            header->state = WorldFileState::Ready;
+        }
+    }
+    // Writes a world file that open() can resume, whether or not this world is backed by one
+    bool save(const std::string &file) const {
+        const WorldFileHeader file_header{
+            .magic = WorldFileHeader::MAGIC,
+            .version = WorldFileHeader::VERSION,
+            .state = WorldFileState::Ready,
+            .w = w,
+            .h = h,
+            .gen = gen,
+            .seed = rng.seed,
+            .rng_state = rng.state,
+            .tile_size = sizeof(Tile),
+            .next_cell_id = next_cell_id
+        };
+        const std::string temp_file = file + ".tmp";
+        {
+            std::ofstream stream(temp_file, std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char *>(&file_header), sizeof(file_header));
+            stream.write(
+                reinterpret_cast<const char *>(tilemap),
+                static_cast<std::streamsize>(sizeof(Tile)) * size
+            );
+            if (!stream) {
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temp_file, file, error);
+        return !error;
+    }
+    void give_birth(Cell &cell, std::uint64_t parent_id) {
+        cell.id = ++next_cell_id;
+        record(LineageEvent::Birth, cell, parent_id);
+    }
+    void record(LineageEvent event, const Cell &cell, std::uint64_t parent_id = 0) {
+        if (lineage) {
+            lineage->append({
+                .cell_id = cell.id,
+                .parent_id = parent_id,
+                .gen = gen,
+                .event = event,
+                .evolutions = static_cast<std::uint8_t>(cell.undergone_evolutions.data.to_ulong())
+            });
+        }
     }
     void destroy() noexcept {
         gen = 0;
         w = 0;
         h = 0;
         size = 0;
-        delete[] tilemap;
+        next_cell_id = 0;
+        if (lineage) {
+            lineage->close();
+            lineage = nullptr;
+        }
+        index = nullptr;
+        stream = nullptr;
+        scheduler = nullptr;
+        domain = nullptr;
+        if (header) {
+            memory::unmap_file(header, mapping_size);
+        } else if (tilemap) {
+            memory::unmap(tilemap, mapping_size);
+        }
+        if (back_tilemap) {
+            memory::unmap(back_tilemap, back_mapping_size);
+        }
+        mapping_size = 0;
+        header = nullptr;
+        tilemap = nullptr;
         ptr = nullptr;
+        back_mapping_size = 0;
+        back_tilemap = nullptr;
+        intents = nullptr;
+    }
+    TileRegion get_region() const noexcept {
+        return { 0, w, 0, h };
+    }
+    // Index of a tile in the whole world, which seeds its random streams
+    std::uint32_t get_tile_key(std::uint16_t x, std::uint16_t y) const noexcept {
+        return (x + origin_x) * static_cast<std::uint32_t>(full_h) + y + origin_y;
     }
     std::uint16_t get_ptr_x() noexcept {
-        return std::distance(tilemap, ptr) % w;
+        return std::distance(tilemap, ptr) / h;
     }
     std::uint16_t get_ptr_y() noexcept {
-        return std::distance(tilemap, ptr) / w;
+        return std::distance(tilemap, ptr) % h;
     }
 };
 
-World world;
-
-std::array<Tile *, 4> find_adjacent_tiles(std::uint16_t x, std::uint16_t y) {
-    return {{
-        y > 0 ? &world[x, y - 1] : nullptr,
-        y < world.h - 1 ? &world[x, y + 1] : nullptr,
-        x > 0 ? &world[x - 1, y] : nullptr,
-        x < world.w - 1 ? &world[x + 1, y] : nullptr
-    }};
-}
+// Aggregates of a rectangle of tiles, merged up the chunk pyramid
+struct RegionSummary {
+    std::uint32_t tile_count, live_cell_count, max_cell_age, max_cell_energy;
+    std::array<std::uint32_t, Evolution::COUNT> evolved_cell_counts;
+    std::uint64_t tile_energy, max_chunk_tile_energy, cell_age_sum;
+    void add(const Tile &tile) noexcept {
+        ++tile_count;
+        tile_energy += tile.energy;
+        if (tile.cell.energy == 0) {
+            return;
+        }
+        ++live_cell_count;
+        cell_age_sum += tile.cell.age;
+        max_cell_age = std::max(max_cell_age, tile.cell.age);
+        max_cell_energy = std::max(max_cell_energy, tile.cell.energy);
+        for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+            evolved_cell_counts[i] += tile.cell.undergone_evolutions[i];
+        }
+    }
+    void merge(const RegionSummary &other) noexcept {
+        tile_count += other.tile_count;
+        live_cell_count += other.live_cell_count;
+        cell_age_sum += other.cell_age_sum;
+        max_cell_age = std::max(max_cell_age, other.max_cell_age);
+        max_cell_energy = std::max(max_cell_energy, other.max_cell_energy);
+        for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+            evolved_cell_counts[i] += other.evolved_cell_counts[i];
+        }
+        tile_energy += other.tile_energy;
+        max_chunk_tile_energy = std::max(max_chunk_tile_energy, other.max_chunk_tile_energy);
+    }
+    bool operator==(const RegionSummary &other) const noexcept = default;
+};
 
-constexpr std::uint32_t
-    GENERATION_TILE_INIT_ENERGY_CAP = 75,
-    GENERATION_TILE_INIT_ENERGY_SUM = 77 * 76 / 2;
+struct TilePos {
+    std::uint16_t x, y;
+};
 
-constexpr std::uint32_t MAX_GENERATION_OPS_PER_TICK = 1000000;
+constexpr std::uint16_t CHUNK_SIZE = 16, MAP_SIZE = 128;
 
-std::uint32_t generate() {
-    static std::uint16_t x = 0, y = 0;
-    static std::uint32_t tiles_generated;
-    std::uint32_t operations = 0;
-    if (x == 0 && y == 0) {
-        tiles_generated = 0;
-    }
-    for (; x < world.w; ++x) {
-        for (; y < world.h; ++y) {
-            if (++operations > MAX_GENERATION_OPS_PER_TICK) {
-                return tiles_generated;
-            }
-            Tile &tile = world[x, y];
-            std::uint32_t base = rng::rand(GENERATION_TILE_INIT_ENERGY_SUM);
-            for (std::uint32_t i = 0; i <= GENERATION_TILE_INIT_ENERGY_CAP; ++i) {
-                if (base <= GENERATION_TILE_INIT_ENERGY_CAP - i) {
-                    tile.energy = i;
-                    break;
+// Pyramid of region summaries over fixed chunks of the world: level 0 holds one summary per
+// chunk and every level above merges 2x2 summaries of the one below, up to a single summary of
+// the whole world. Queries descend it in logarithmic time and only scan the tiles of one chunk.
+class ChunkIndex {
+public:
+    struct Level {
+        std::uint16_t w, h;
+        std::vector<RegionSummary> summaries;
+        // The update each summary last changed in, so readers only copy what changed since
+        std::vector<std::uint32_t> update_serials;
+        std::uint32_t get_idx(std::uint16_t x, std::uint16_t y) const noexcept {
+            return x * static_cast<std::uint32_t>(h) + y;
+        }
+        RegionSummary &operator[](std::uint16_t x, std::uint16_t y) noexcept {
+            return summaries[get_idx(x, y)];
+        }
+        const RegionSummary &operator[](std::uint16_t x, std::uint16_t y) const noexcept {
+            return summaries[get_idx(x, y)];
+        }
+    };
+private:
+    std::vector<Level> levels;
+    // Level 0 as the running update accumulates it, only copied over where it changed
+    std::vector<RegionSummary> pending;
+    std::uint32_t update_serial;
+    // Walks from the root down to a chunk, taking the first child the pick accepts
+    template <typename Pick>
+    TilePos descend(Pick pick) const {
+        TilePos chunk{ 0, 0 };
+        for (std::size_t i = levels.size() - 1; i-- > 0;) {
+            const Level &level = levels[i];
+            const std::uint16_t
+                x_begin = chunk.x * 2,
+                y_begin = chunk.y * 2,
+                x_end = std::min(x_begin + 2, +level.w),
+                y_end = std::min(y_begin + 2, +level.h);
+            bool is_picked = false;
+            for (std::uint16_t x = x_begin; !is_picked && x < x_end; ++x) {
+                for (std::uint16_t y = y_begin; !is_picked && y < y_end; ++y) {
+                    if (pick(level[x, y])) {
+                        chunk = { x, y };
+                        is_picked = true;
+                    }
                 }
-                base -= GENERATION_TILE_INIT_ENERGY_CAP + 1 - i;
             }
-            if (rng::chance(10)) {
-                tile.cell.energy = rng::rand(6) + 5;
-            }
-            ++tiles_generated;
         }
-        y = 0;
+        return chunk;
     }
-    x = 0;
-    y = 0;
-    return tiles_generated;
-}
-
-void advance_age() {
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
-            Tile &tile = world[x, y];
-            tile.active_evs.clear();
-            tile.cell.utilized_evolutions.clear();
-            if (world.gen % 10 == 0) {
-                ++tile.energy;
-            }
-            if (tile.cell.energy != 0) {
-                ++tile.cell.age;
+    template <typename Predicate>
+    static std::optional<TilePos> find_in_chunk(World &world, TilePos chunk, Predicate predicate) {
+        const std::uint16_t
+            x_begin = chunk.x * CHUNK_SIZE,
+            y_begin = chunk.y * CHUNK_SIZE,
+            x_end = std::min<std::uint32_t>(x_begin + CHUNK_SIZE, world.w),
+            y_end = std::min<std::uint32_t>(y_begin + CHUNK_SIZE, world.h);
+        for (std::uint16_t x = x_begin; x < x_end; ++x) {
+            for (std::uint16_t y = y_begin; y < y_end; ++y) {
+                if (predicate(world[x, y])) {
+                    return TilePos{ x, y };
+                }
             }
         }
+        return std::nullopt;
     }
-}
-
-void advance_harvesting() {
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
-            Tile &tile = world[x, y];
-            if (tile.cell.energy == 0 || tile.cell.ongoing_evolution) {
-                continue;
+public:
+    ChunkIndex() : levels{}, pending{}, update_serial{ 0 } {}
+    void begin_update() noexcept {
+        std::ranges::fill(pending, RegionSummary{});
+    }
+    void add(std::uint16_t x, std::uint16_t y, const Tile &tile) noexcept {
+        pending[levels.front().get_idx(x / CHUNK_SIZE, y / CHUNK_SIZE)].add(tile);
+    }
+    // Merges up only the summaries whose chunks changed during the update
+    void end_update() noexcept {
+        ++update_serial;
+        Level &chunks = levels.front();
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            pending[i].max_chunk_tile_energy = pending[i].tile_energy;
+            if (pending[i] != chunks.summaries[i]) {
+                chunks.summaries[i] = pending[i];
+                chunks.update_serials[i] = update_serial;
             }
-            std::uint32_t
-                harvested_energy =
-                    (tile.energy >= 100 ? 3 : tile.energy >= 50 ? 2 : 1) +
-                    (tile.cell.age >= 40 ? 2 : tile.cell.age >= 20 ? 1 : 0),
-                actual_harvested_energy = std::min(harvested_energy, tile.energy);
-            tile.energy -= actual_harvested_energy;
-            tile.cell.energy += actual_harvested_energy;
-            if (tile.cell.undergone_evolutions[Evolution::Energosynthesis]) {
-                std::uint8_t free_neighbor_count = 0;
-                if (x > 0) {
-                    if (world[x - 1, y].cell.energy == 0) {
-                        ++free_neighbor_count;
-                    }
-                    if (y > 0 && world[x - 1, y - 1].cell.energy == 0) {
-                        ++free_neighbor_count;
-                    }
-                    if (y < world.h - 1 && world[x - 1, y + 1].cell.energy == 0) {
-                        ++free_neighbor_count;
-                    }
-                }
-                if (x < world.w - 1) {
-                    if (world[x + 1, y].cell.energy == 0) {
-                        ++free_neighbor_count;
-                    }
-                    if (y > 0 && world[x + 1, y - 1].cell.energy == 0) {
-                        ++free_neighbor_count;
+        }
+        for (std::size_t i = 1; i < levels.size(); ++i) {
+            const Level &below = levels[i - 1];
+            Level &level = levels[i];
+            for (std::uint16_t x = 0; x < level.w; ++x) {
+                const std::uint16_t cx_end = std::min(x * 2 + 2, +below.w);
+                for (std::uint16_t y = 0; y < level.h; ++y) {
+                    const std::uint16_t cy_end = std::min(y * 2 + 2, +below.h);
+                    bool has_changed = false;
+                    for (std::uint16_t cx = x * 2; cx < cx_end; ++cx) {
+                        for (std::uint16_t cy = y * 2; cy < cy_end; ++cy) {
+                            has_changed |=
+                                below.update_serials[below.get_idx(cx, cy)] == update_serial;
+                        }
                     }
-                    if (y < world.h - 1 && world[x + 1, y + 1].cell.energy == 0) {
-                        ++free_neighbor_count;
+                    if (!has_changed) {
+                        continue;
                     }
-                }
-                if (y > 0 && world[x, y - 1].cell.energy == 0) {
-                    ++free_neighbor_count;
-                }
-                if (y < world.h - 1 && world[x, y + 1].cell.energy == 0) {
-                    ++free_neighbor_count;
-                }
-                if (free_neighbor_count >= 1 || rng::chance(2)) {
-                    tile.cell.utilized_evolutions += Evolution::Energosynthesis;
-                    tile.active_evs += Event::Synthesize;
-                    ++tile.cell.energy;
-                    if (free_neighbor_count >= 4) {
-                        ++tile.cell.energy;
-                        if (free_neighbor_count == 8) {
-                            ++tile.cell.energy;
+                    RegionSummary summary{};
+                    for (std::uint16_t cx = x * 2; cx < cx_end; ++cx) {
+                        for (std::uint16_t cy = y * 2; cy < cy_end; ++cy) {
+                            summary.merge(below[cx, cy]);
                         }
                     }
+                    if (summary != level[x, y]) {
+                        level[x, y] = summary;
+                        level.update_serials[level.get_idx(x, y)] = update_serial;
+                    }
                 }
             }
         }
     }
-}
+    // Sizes the pyramid for the world and summarizes every tile of it
+    void rebuild(World &world) {
+        levels.clear();
+        std::uint16_t
+            w = (world.w + CHUNK_SIZE - 1) / CHUNK_SIZE,
+            h = (world.h + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        while (true) {
+            const std::size_t size = static_cast<std::size_t>(w) * h;
+            levels.push_back({
+                w, h, std::vector<RegionSummary>(size), std::vector<std::uint32_t>(size)
+            });
+            if (w == 1 && h == 1) {
+                break;
+            }
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+        pending.resize(levels.front().summaries.size());
+        begin_update();
+        for (std::uint16_t x = 0; x < world.w; ++x) {
+            for (std::uint16_t y = 0; y < world.h; ++y) {
+                add(x, y, world[x, y]);
+            }
+        }
+        end_update();
+        // Everything counts as changed for readers that still hold a previous world
+        for (Level &level : levels) {
+            std::ranges::fill(level.update_serials, update_serial);
+        }
+    }
+    std::uint32_t get_update_serial() const noexcept {
+        return update_serial;
+    }
+    // The finest level that fits within MAP_SIZE in both dimensions, for minimaps and heatmaps
+    std::size_t get_map_level() const noexcept {
+        std::size_t i = 0;
+        while (levels[i].w > MAP_SIZE || levels[i].h > MAP_SIZE) {
+            ++i;
+        }
+        return i;
+    }
+    const Level &get_level(std::size_t i) const noexcept {
+        return levels[i];
+    }
+    const RegionSummary &get_summary() const noexcept {
+        return levels.back()[0, 0];
+    }
+    std::optional<TilePos> find_oldest_cell(World &world) const {
+        const std::uint32_t max_cell_age = get_summary().max_cell_age;
+        if (get_summary().live_cell_count == 0) {
+            return std::nullopt;
+        }
+        return find_in_chunk(
+            world,
+            descend([=](const RegionSummary &summary) {
+                return summary.live_cell_count != 0 && summary.max_cell_age == max_cell_age;
+            }),
+            [=](const Tile &tile) {
+                return tile.cell.energy != 0 && tile.cell.age == max_cell_age;
+            }
+        );
+    }
+    // The tile holding the most energy within the chunk holding the most energy
+    std::optional<TilePos> find_richest_chunk(World &world) const {
+        const std::uint64_t max_chunk_tile_energy = get_summary().max_chunk_tile_energy;
+        const TilePos chunk = descend([=](const RegionSummary &summary) {
+            return summary.max_chunk_tile_energy == max_chunk_tile_energy;
+        });
+        std::uint32_t max_tile_energy = 0;
+        find_in_chunk(world, chunk, [&](const Tile &tile) {
+            max_tile_energy = std::max(max_tile_energy, tile.energy);
+            return false;
+        });
+        return find_in_chunk(world, chunk, [=](const Tile &tile) {
+            return tile.energy == max_tile_energy;
+        });
+    }
+    // The nth cell that underwent the evolution, in pyramid order, wrapping around past the last
+    std::optional<TilePos> find_evolved_cell(
+        World &world,
+        std::uint8_t evolution,
+        std::uint32_t n
+    ) const {
+        const std::uint32_t evolved_cell_count = get_summary().evolved_cell_counts[evolution];
+        if (evolved_cell_count == 0) {
+            return std::nullopt;
+        }
+        n %= evolved_cell_count;
+        const TilePos chunk = descend([&](const RegionSummary &summary) {
+            if (n < summary.evolved_cell_counts[evolution]) {
+                return true;
+            }
+            n -= summary.evolved_cell_counts[evolution];
+            return false;
+        });
+        return find_in_chunk(world, chunk, [&](const Tile &tile) {
+            if (tile.cell.energy == 0 || !tile.cell.undergone_evolutions[evolution]) {
+                return false;
+            }
+            return n-- == 0;
+        });
+    }
+};
+
+// Header of a shared-memory state stream, followed by two buffers of buffer_size bytes. Each
+// buffer starts with a StreamBufferHeader and holds one array per entry of array_offsets (from
+// the start of the buffer), indexed like the tilemap: tile energy, cell energy and cell age as
+// u32, cell evolutions as u8 (undergone bits, ongoing evolution plus one in the high nibble) and
+// tile events as u32 bits.
+struct alignas(64) StreamHeader {
+    static constexpr std::array<char, 8> MAGIC{ 'E', 'V', 'O', 'S', 'T', 'R', 'E', 'A' };
+    static constexpr std::uint32_t VERSION = 1;
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint16_t w, h;
+    std::uint64_t buffer_size;
+    std::array<std::uint64_t, 5> array_offsets;
+    // Buffer holding the last published generation
+    std::atomic<std::uint32_t> latest_buffer;
+};
+
+// A seqlock: odd while the buffer is being written. Readers read the sequence, the data and the
+// sequence again, and discard what they read unless both sequences are equal and even.
+struct alignas(64) StreamBufferHeader {
+    std::atomic<std::uint64_t> sequence;
+    std::uint32_t gen, seed;
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+// Publishes every generation into POSIX shared memory, alternating between two buffers so that
+// readers get a whole generation's time to consume the latest one in place
+class StateStream {
+    std::string name;
+    StreamHeader *header;
+    std::size_t mapping_size;
+    StreamBufferHeader &get_buffer(std::uint32_t i) noexcept {
+        return *reinterpret_cast<StreamBufferHeader *>(
+            reinterpret_cast<std::uint8_t *>(header + 1) + i * header->buffer_size
+        );
+    }
+    template <typename T>
+    T *get_array(StreamBufferHeader &buffer, std::uint8_t i) noexcept {
+        return reinterpret_cast<T *>(
+            reinterpret_cast<std::uint8_t *>(&buffer) + header->array_offsets[i]
+        );
+    }
+public:
+    StateStream() : name{}, header{ nullptr }, mapping_size{ 0 } {}
+    ~StateStream() {
+        close();
+    }
+    // Names are POSIX shared-memory names, the leading slash is optional
+    bool open(const std::string &new_name, std::uint16_t w, std::uint16_t h) {
+        close();
+#ifdef _WIN32
+        static_cast<void>(new_name);
+        static_cast<void>(w);
+        static_cast<void>(h);
+        return false;
+#else
+        name = new_name.starts_with('/') ? new_name : "/" + new_name;
+        const std::uint64_t size = static_cast<std::uint64_t>(w) * h;
+        const auto align = [](std::uint64_t offset) {
+            return (offset + 63) / 64 * 64;
+        };
+        std::array<std::uint64_t, 5> array_offsets;
+        array_offsets[0] = sizeof(StreamBufferHeader);
+        array_offsets[1] = align(array_offsets[0] + size * sizeof(std::uint32_t));
+        array_offsets[2] = align(array_offsets[1] + size * sizeof(std::uint32_t));
+        array_offsets[3] = align(array_offsets[2] + size * sizeof(std::uint32_t));
+        array_offsets[4] = align(array_offsets[3] + size * sizeof(std::uint8_t));
+        const std::uint64_t buffer_size =
+            align(array_offsets[4] + size * sizeof(std::uint32_t));
+        const std::int32_t fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1) {
+            return false;
+        }
+        mapping_size = sizeof(StreamHeader) + 2 * buffer_size;
+        void *ptr = ftruncate(fd, mapping_size) == 0 ?
+            mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) :
+            MAP_FAILED;
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            return false;
+        }
+        header = static_cast<StreamHeader *>(ptr);
+        header->magic = StreamHeader::MAGIC;
+        header->version = StreamHeader::VERSION;
+        header->w = w;
+        header->h = h;
+        header->buffer_size = buffer_size;
+        header->array_offsets = array_offsets;
+        header->latest_buffer.store(0, std::memory_order_release);
+        return true;
+#endif
+    }
+    void publish(const World &world) noexcept {
+        if (!header) {
+            return;
+        }
+        const std::uint32_t i = 1 - header->latest_buffer.load(std::memory_order_relaxed);
+        StreamBufferHeader &buffer = get_buffer(i);
+        const std::uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+        buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        buffer.gen = world.gen;
+        buffer.seed = world.rng.seed;
+        std::uint32_t
+            *tile_energies = get_array<std::uint32_t>(buffer, 0),
+            *cell_energies = get_array<std::uint32_t>(buffer, 1),
+            *cell_ages = get_array<std::uint32_t>(buffer, 2),
+            *events = get_array<std::uint32_t>(buffer, 4);
+        std::uint8_t *cell_evolutions = get_array<std::uint8_t>(buffer, 3);
+        for (std::uint32_t j = 0; j < world.size; ++j) {
+            const Tile &tile = world.tilemap[j];
+            tile_energies[j] = tile.energy;
+            cell_energies[j] = tile.cell.energy;
+            cell_ages[j] = tile.cell.age;
+            cell_evolutions[j] =
+                tile.cell.undergone_evolutions.data.to_ulong() |
+                tile.cell.ongoing_evolution << 4;
+            events[j] = tile.active_evs.data.to_ulong();
+        }
+        buffer.sequence.store(sequence + 2, std::memory_order_release);
+        header->latest_buffer.store(i, std::memory_order_release);
+    }
+    // Readers keep their mappings, only the name goes away
+    void close() noexcept {
+#ifndef _WIN32
+        if (header) {
+            munmap(header, mapping_size);
+            shm_unlink(name.c_str());
+        }
+#endif
+        header = nullptr;
+        mapping_size = 0;
+    }
+};
+
+StateStream state_stream;
+
+World world;
+
+ChunkIndex chunk_index;
+
+LineageLog lineage_log;
+
+// Stands in for every tile beyond the world's edges: permanently occupied and without energy, so
+// nothing ever moves or divides into it, and neighbors need no null checks. It stays unwritten
+// only because callers write to nothing but neighbors they found free (cell.energy == 0).
+Tile border_tile{ .energy = 0, .active_evs = {}, .cell = { .energy = 1 } };
+
+// Visits the tiles of a region in scan order along with whether each is an interior tile, as a
+// std::bool_constant. The world's edge rows and columns are split out of the loops, so interior
+// tiles can reach their neighbors without a single bounds check.
+template <typename Visit>
+void for_each_tile(const World &world, const TileRegion &region, const Visit &visit) {
+    const std::uint16_t
+        y_interior_begin = std::max<std::uint16_t>(region.y_begin, 1),
+        y_interior_end = std::max<std::uint16_t>(
+            std::min<std::uint16_t>(region.y_end, world.h - 1), y_interior_begin
+        );
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        if (x == 0 || x == world.w - 1) {
+            for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+                visit(x, y, std::false_type{});
+            }
+            continue;
+        }
+        for (std::uint16_t y = region.y_begin; y < y_interior_begin; ++y) {
+            visit(x, y, std::false_type{});
+        }
+        for (std::uint16_t y = y_interior_begin; y < y_interior_end; ++y) {
+            visit(x, y, std::true_type{});
+        }
+        for (std::uint16_t y = y_interior_end; y < region.y_end; ++y) {
+            visit(x, y, std::false_type{});
+        }
+    }
+}
+
+template <bool is_interior = false>
+std::array<Tile *, 4> find_adjacent_tiles(World &world, std::uint16_t x, std::uint16_t y) {
+    Tile *tile = &world[x, y];
+    if constexpr (is_interior) {
+        return {{ tile - 1, tile + 1, tile - world.h, tile + world.h }};
+    } else {
+        return {{
+            y > 0 ? tile - 1 : &border_tile,
+            y < world.h - 1 ? tile + 1 : &border_tile,
+            x > 0 ? tile - world.h : &border_tile,
+            x < world.w - 1 ? tile + world.h : &border_tile
+        }};
+    }
+}
+
+// Free tiles among the 8 around one, as told by is_free for a tile index. Those of interior
+// tiles sit at fixed offsets, which leaves the bounds checks to the tiles on the world's edges.
+template <bool is_interior = false, typename IsFree>
+std::uint8_t count_free_neighbors(
+    const World &world,
+    std::uint16_t x,
+    std::uint16_t y,
+    const IsFree &is_free
+) noexcept {
+    const std::int32_t h = world.h;
+    const std::int32_t i = x * h + y;
+    std::uint8_t free_neighbor_count = 0;
+    if constexpr (is_interior) {
+        for (const std::int32_t offset : { -h - 1, -h, -h + 1, -1, 1, h - 1, h, h + 1 }) {
+            free_neighbor_count += is_free(i + offset);
+        }
+        return free_neighbor_count;
+    }
+    for (std::int32_t dx = -1; dx <= 1; ++dx) {
+        for (std::int32_t dy = -1; dy <= 1; ++dy) {
+            const std::int32_t adjacent_x = x + dx, adjacent_y = y + dy;
+            free_neighbor_count +=
+                (dx != 0 || dy != 0) &&
+                adjacent_x >= 0 && adjacent_x < world.w &&
+                adjacent_y >= 0 && adjacent_y < world.h &&
+                is_free(i + dx * h + dy);
+        }
+    }
+    return free_neighbor_count;
+}
+
+// Streams of Rng::for_tile, one per phase of a synchronous update
+constexpr std::uint8_t
+    RNG_PHASE_HARVESTING   = 0,
+    RNG_PHASE_CLAIM        = 1,
+    RNG_PHASE_REPRODUCTION = 2,
+    RNG_PHASE_EVOLUTION    = 3;
+
+constexpr std::uint32_t NO_TILE = std::numeric_limits<std::uint32_t>::max();
+
+constexpr std::uint8_t NO_DIRECTION = 0xFF;
+
+// An intent holds a bit per direction (up, down, left, right) the cell claims a tile in, and
+// for births whether the cell reproduces at all, since polydivision does even without room
+constexpr std::uint8_t INTENT_REPRODUCING = 1 << 4;
+
+// Same order as find_adjacent_tiles, so the opposite of direction i is i ^ 1
+std::array<std::uint32_t, 4> find_adjacent_indices(
+    const World &world,
+    std::uint16_t x,
+    std::uint16_t y
+) noexcept {
+    const std::uint32_t i = x * static_cast<std::uint32_t>(world.h) + y;
+    return {{
+        y > 0 ? i - 1 : NO_TILE,
+        y < world.h - 1u ? i + 1 : NO_TILE,
+        x > 0 ? i - world.h : NO_TILE,
+        x < world.w - 1u ? i + world.h : NO_TILE
+    }};
+}
+
+std::array<std::uint32_t, 4> find_adjacent_indices(const World &world, std::uint32_t i) noexcept {
+    return find_adjacent_indices(world, i / world.h, i % world.h);
+}
+
+std::array<std::uint32_t, 4> find_adjacent_keys(const World &world, std::uint32_t key) noexcept {
+    return {{ key - 1, key + 1, key - world.full_h, key + world.full_h }};
+}
+
+// Contested tiles go to the cell with the most energy, then to a hash of its position, so that
+// no visiting order is favoured
+std::uint64_t get_claim_priority(
+    const World &world,
+    const Tile *tiles,
+    std::uint32_t i,
+    std::uint32_t key
+) noexcept {
+    return
+        static_cast<std::uint64_t>(tiles[i].cell.energy) << 32 |
+        Rng::for_tile(world.rng.seed, world.gen, key, RNG_PHASE_CLAIM).rand();
+}
+
+// Direction from a tile to the neighbor whose claim on it wins, if any
+std::uint8_t find_claim_winner(
+    const World &world,
+    const Tile *tiles,
+    const std::uint8_t *intents,
+    const std::array<std::uint32_t, 4> &adjacent_indices,
+    std::uint32_t key
+) noexcept {
+    const std::array<std::uint32_t, 4> adjacent_keys = find_adjacent_keys(world, key);
+    std::uint8_t winner = NO_DIRECTION;
+    std::uint64_t winner_priority = 0;
+    for (std::uint8_t direction = 0; direction < 4; ++direction) {
+        const std::uint32_t j = adjacent_indices[direction];
+        if (j == NO_TILE || !(intents[j] >> (direction ^ 1) & 1)) {
+            continue;
+        }
+        const std::uint64_t priority =
+            get_claim_priority(world, tiles, j, adjacent_keys[direction]);
+        if (winner == NO_DIRECTION || priority > winner_priority) {
+            winner = direction;
+            winner_priority = priority;
+        }
+    }
+    return winner;
+}
+
+constexpr std::uint32_t
+    GENERATION_TILE_INIT_ENERGY_CAP = 75,
+    GENERATION_TILE_INIT_ENERGY_SUM = 77 * 76 / 2;
 
-void advance_living() {
+bool generate(
+    World &world,
+    std::stop_token stop_token,
+    std::atomic<std::uint32_t> &tiles_generated
+) {
     for (std::uint16_t x = 0; x < world.w; ++x) {
+        if (stop_token.stop_requested()) {
+            return false;
+        }
         for (std::uint16_t y = 0; y < world.h; ++y) {
+            Tile &tile = world[x, y];
+            std::uint32_t base = world.rng.rand(GENERATION_TILE_INIT_ENERGY_SUM);
+            for (std::uint32_t i = 0; i <= GENERATION_TILE_INIT_ENERGY_CAP; ++i) {
+                if (base <= GENERATION_TILE_INIT_ENERGY_CAP - i) {
+                    tile.energy = i;
+                    break;
+                }
+                base -= GENERATION_TILE_INIT_ENERGY_CAP + 1 - i;
+            }
+            if (world.rng.chance(rules.generation_cell_odds)) {
+                tile.cell.energy = world.rng.rand(6) + 5;
+                world.give_birth(tile.cell, 0);
+            }
+        }
+        tiles_generated.fetch_add(world.h, std::memory_order_relaxed);
+    }
+    if (world.index) {
+        world.index->rebuild(world);
+    }
+    if (world.stream) {
+        world.stream->publish(world);
+    }
+    world.end_update();
+    return true;
+}
+
+class Generator {
+    std::atomic<std::uint32_t> tiles_generated;
+    std::atomic<bool> is_done;
+    std::jthread thread;
+public:
+    Generator() : tiles_generated{ 0 }, is_done{ false }, thread{} {}
+    void start() {
+        tiles_generated.store(0, std::memory_order_relaxed);
+        is_done.store(false, std::memory_order_relaxed);
+        thread = std::jthread([this](std::stop_token stop_token) {
+            if (generate(world, stop_token, tiles_generated)) {
+                is_done.store(true, std::memory_order_release);
+            }
+        });
+    }
+    void cancel() {
+        if (!thread.joinable()) {
+            return;
+        }
+        thread.request_stop();
+        thread.join();
+    }
+    bool finish() {
+        if (!is_done.load(std::memory_order_acquire)) {
+            return false;
+        }
+        thread.join();
+        return true;
+    }
+    std::uint32_t get_tiles_generated() const noexcept {
+        return tiles_generated.load(std::memory_order_relaxed);
+    }
+};
+
+Generator generator;
+
+template <bool is_default>
+void advance_age(World &world, const TileRegion &region) {
+    const Rules &rules = get_rules<is_default>();
+    const bool is_energy_tick = world.gen % rules.energy_tick_interval == 0;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+            Tile &tile = world[x, y];
+            tile.active_evs.clear();
+            tile.cell.utilized_evolutions.clear();
+            if (is_energy_tick) {
+                ++tile.energy;
+            }
+            if (tile.cell.energy != 0) {
+                ++tile.cell.age;
+            }
+        }
+    }
+}
+
+// Harvests run side by side in the synchronous passes, so they read whether their neighbors are
+// occupied from the snapshot advance_occupancy leaves in the intents rather than from the tiles
+// other threads are harvesting into
+template <bool is_default, std::uint8_t enabled_evolutions, bool is_synchronous = false>
+void advance_harvesting(World &world, const TileRegion &region) {
+    const Rules &rules = get_rules<is_default>();
+    const std::uint32_t phase_key =
+        Rng::get_phase_key(world.rng.seed, world.gen, RNG_PHASE_HARVESTING);
+    const Tile *tiles = world.tilemap;
+    const std::uint8_t *occupancy = world.intents;
+    const auto is_free = [&](std::int32_t i) {
+        return is_synchronous ? occupancy[i] == 0 : tiles[i].cell.energy == 0;
+    };
+    for_each_tile(world, region, [&](std::uint16_t x, std::uint16_t y, auto is_interior) {
+        Tile &tile = world[x, y];
+        if (tile.cell.energy == 0 || tile.cell.ongoing_evolution) {
+            return;
+        }
+        std::uint32_t
+            harvested_energy =
+                (
+                    tile.energy >= rules.harvest_tile_energy_high ? 3 :
+                    tile.energy >= rules.harvest_tile_energy_low ? 2 : 1
+                ) +
+                (
+                    tile.cell.age >= rules.harvest_age_high ? 2 :
+                    tile.cell.age >= rules.harvest_age_low ? 1 : 0
+                ),
+            actual_harvested_energy = std::min(harvested_energy, tile.energy);
+        tile.energy -= actual_harvested_energy;
+        tile.cell.energy += actual_harvested_energy;
+        if (
+            is_evolution_enabled(enabled_evolutions, Evolution::Energosynthesis) &&
+            tile.cell.undergone_evolutions[Evolution::Energosynthesis]
+        ) {
+            const std::uint8_t free_neighbor_count =
+                count_free_neighbors<is_interior>(world, x, y, is_free);
+            if (
+                free_neighbor_count >= 1 ||
+                (
+                    is_synchronous ?
+                        Rng::for_tile(world.rng.seed, phase_key, world.get_tile_key(x, y))
+                            .chance(2) :
+                        world.rng.chance(2)
+                )
+            ) {
+                tile.cell.utilized_evolutions += Evolution::Energosynthesis;
+                tile.active_evs += Event::Synthesize;
+                ++tile.cell.energy;
+                if (free_neighbor_count >= 4) {
+                    ++tile.cell.energy;
+                    if (free_neighbor_count == 8) {
+                        ++tile.cell.energy;
+                    }
+                }
+            }
+        }
+    });
+}
+
+template <bool is_default>
+void advance_living(World &world, const TileRegion &region) {
+    const Rules &rules = get_rules<is_default>();
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
             Tile &tile = world[x, y];
             if (tile.cell.energy == 0) {
                 continue;
             }
             const std::uint32_t living_cost =
-                tile.cell.age / 100 + !!(tile.cell.age % 100);
+                tile.cell.age / rules.living_cost_age_step +
+                !!(tile.cell.age % rules.living_cost_age_step);
             if (tile.cell.energy > living_cost) {
                 tile.cell.energy -= living_cost;
                 continue;
             }
             tile.cell.energy = 0;
+            world.record(LineageEvent::Death, tile.cell);
             tile.active_evs -= Event::Synthesize;
             tile.energy += tile.cell.age;
             tile.cell.age = 0;
-            tile.cell.ongoing_evolution = nullptr;
+            tile.cell.ongoing_evolution = 0;
             tile.cell.ongoing_evolution_progress = 0;
             tile.cell.undergone_evolutions.clear();
             if (world.ptr == &tile) {
@@ -1260,20 +3263,22 @@ void advance_living() {
     }
 }
 
-void advance_pulsing() {
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
+template <bool is_default>
+void advance_pulsing(World &world, const TileRegion &region) {
+    const Rules &rules = get_rules<is_default>();
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
             Tile &tile = world[x, y];
             if (!tile.cell.ongoing_evolution) {
                 continue;
             }
             if (
                 ++tile.cell.ongoing_evolution_progress ==
-                tile.cell.ongoing_evolution->timescale
+                rules.evolutions[tile.cell.ongoing_evolution - 1].timescale
             ) {
-                tile.cell.undergone_evolutions +=
-                    std::distance(EVOLUTIONS.data(), tile.cell.ongoing_evolution);
-                tile.cell.ongoing_evolution = nullptr;
+                tile.cell.undergone_evolutions += tile.cell.ongoing_evolution - 1;
+                world.record(LineageEvent::Evolutions, tile.cell);
+                tile.cell.ongoing_evolution = 0;
                 tile.cell.ongoing_evolution_progress = 0;
             }
             tile.active_evs += Event::Pulse;
@@ -1281,718 +3286,5750 @@ void advance_pulsing() {
     }
 }
 
-void advance_instinct() {
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
-            Tile &tile = world[x, y];
-            if (tile.active_evs.any(Event::Synthesize)) {
-                continue;
-            }
-            if (
-                tile.cell.undergone_evolutions[Evolution::Motility] &&
-                tile.cell.energy >= 3
-            ) {
-                Tile *selected_tile = &tile;
-                std::array<Tile *, 4> adjacent_tiles = find_adjacent_tiles(x, y);
-                std::uint8_t direction = 0;
-                for (std::uint8_t i = 0; i < 4; ++i) {
-                    if (
-                        adjacent_tiles[i] &&
-                        adjacent_tiles[i]->cell.energy == 0 &&
-                        adjacent_tiles[i]->energy > selected_tile->energy
-                    ) {
-                        selected_tile = adjacent_tiles[i];
-                        direction = i;
-                    }
-                }
-                if (selected_tile != &tile) {
-                    bool is_synthesizing = tile.active_evs[Event::Synthesize];
-                    if (is_synthesizing) {
-                        tile.active_evs -= Event::Synthesize;
-                        tile.active_evs += Event::SynthesizeAndMoveFromUp + direction;
-                    } else {
-                        tile.active_evs += Event::MoveFromUp + direction;
-                    }
-                    selected_tile->cell = tile.cell;
-                    tile.cell.age = 0;
-                    tile.cell.energy = 0;
-                    tile.cell.undergone_evolutions.clear();
-                    if (world.ptr == &tile) {
-                        world.ptr = selected_tile;
-                    }
-                    selected_tile->cell.utilized_evolutions += Evolution::Motility;
-                    if (is_synthesizing) {
-                        selected_tile->active_evs += Event::SynthesizeAndMoveToUp + direction;
-                    } else {
-                        selected_tile->active_evs += Event::MoveToUp + direction;
-                    }
-                    continue;
-                }
-            }
-        }
+template <std::uint8_t enabled_evolutions>
+void advance_instinct(World &world) {
+    if constexpr (!is_evolution_enabled(enabled_evolutions, Evolution::Motility)) {
+        return;
     }
-}
-
-void advance_reproduction() {
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
-            Tile &tile = world[x, y];
-            if (
-                tile.active_evs.any(
-                    Event::Synthesize,
-                    Event::SynthesizeAndMoveToUp,
-                    Event::SynthesizeAndMoveToDown,
-                    Event::SynthesizeAndMoveToLeft,
-                    Event::SynthesizeAndMoveToRight
-                ) ||
-                tile.cell.age < 10 ||
-                tile.cell.energy < 10 ||
-                (
-                    tile.cell.undergone_evolutions[Evolution::Polydivision] &&
-                    tile.cell.energy < 20
-                ) ||
-                !rng::chance(
-                    tile.cell.undergone_evolutions[Evolution::Polydivision] ? 16 : 8
-                )
-            ) {
-                continue;
-            }
-            std::array<Tile *, 4> adjacent_tiles = find_adjacent_tiles(x, y);
-            if (tile.cell.undergone_evolutions[Evolution::Polydivision]) {
-                std::bitset<4> tile_selections;
-                for (std::uint8_t i = 0; i < 4; ++i) {
-                    if (
-                        adjacent_tiles[i] &&
-                        adjacent_tiles[i]->cell.energy == 0
-                    ) {
-                        tile_selections[i] = true;
-                    }
-                }
-                tile.cell.energy /= tile_selections.count() + 1;
-                for (std::uint8_t i = 0; i < 4; ++i) {
-                    if (tile_selections[i]) {
-                        tile.cell.utilized_evolutions += Evolution::Polydivision;
-                        tile.active_evs += Event::DivideUp + i;
-                        adjacent_tiles[i]->cell.age = 0;
-                        adjacent_tiles[i]->cell.energy = tile.cell.energy;
-                        for (std::uint8_t j = 0; j < Evolution::COUNT; ++j) {
-                            if (tile.cell.undergone_evolutions[j] && rng::chance(2)) {
-                                adjacent_tiles[i]->cell.undergone_evolutions += j;
-                            }
-                        }
-                        adjacent_tiles[i]->active_evs += Event::SpawnUp + i;
-                    }
-                }
-                for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
-                    if (tile.cell.undergone_evolutions[i] && !rng::chance(2)) {
-                        tile.cell.undergone_evolutions -= i;
-                    }
-                }
-                continue;
-            }
-            Tile *selected_tile = nullptr;
+    const TileRegion region = world.get_region();
+    for_each_tile(world, region, [&](std::uint16_t x, std::uint16_t y, auto is_interior) {
+        Tile &tile = world[x, y];
+        if (tile.active_evs.any(Event::Synthesize)) {
+            return;
+        }
+        if (
+            tile.cell.undergone_evolutions[Evolution::Motility] &&
+            tile.cell.energy >= 3
+        ) {
+            Tile *selected_tile = &tile;
+            std::array<Tile *, 4> adjacent_tiles = find_adjacent_tiles<is_interior>(world, x, y);
             std::uint8_t direction = 0;
+            // Only a free tile is selected and moved into, so never the border tile
             for (std::uint8_t i = 0; i < 4; ++i) {
                 if (
-                    adjacent_tiles[i] &&
                     adjacent_tiles[i]->cell.energy == 0 &&
-                    (
-                        !selected_tile ||
-                        adjacent_tiles[i]->energy > selected_tile->energy
-                    )
+                    adjacent_tiles[i]->energy > selected_tile->energy
                 ) {
                     selected_tile = adjacent_tiles[i];
                     direction = i;
                 }
             }
-            if (selected_tile) {
-                tile.active_evs += Event::DivideUp + direction;
-                tile.cell.energy /= 2;
-                selected_tile->cell.age = 0;
-                selected_tile->cell.energy = tile.cell.energy;
-                for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
-                    if (tile.cell.undergone_evolutions[i]) {
-                        if (rng::chance(2)) {
-                            selected_tile->cell.undergone_evolutions += i;
-                        }
-                        if (!rng::chance(2)) {
-                            tile.cell.undergone_evolutions -= i;
-                        }
-                    }
+            if (selected_tile != &tile) {
+                bool is_synthesizing = tile.active_evs[Event::Synthesize];
+                if (is_synthesizing) {
+                    tile.active_evs -= Event::Synthesize;
+                    tile.active_evs += Event::SynthesizeAndMoveFromUp + direction;
+                } else {
+                    tile.active_evs += Event::MoveFromUp + direction;
+                }
+                selected_tile->cell = tile.cell;
+                tile.cell.age = 0;
+                tile.cell.energy = 0;
+                tile.cell.undergone_evolutions.clear();
+                if (world.ptr == &tile) {
+                    world.ptr = selected_tile;
+                }
+                selected_tile->cell.utilized_evolutions += Evolution::Motility;
+                if (is_synthesizing) {
+                    selected_tile->active_evs += Event::SynthesizeAndMoveToUp + direction;
+                } else {
+                    selected_tile->active_evs += Event::MoveToUp + direction;
                 }
-                selected_tile->active_evs += Event::SpawnUp + direction;
             }
         }
-    }
+    });
 }
 
-void advance_evolution() {
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
-            Tile &tile = world[x, y];
-            if (tile.cell.ongoing_evolution) {
-                continue;
+template <bool is_default, std::uint8_t enabled_evolutions>
+void advance_reproduction(World &world) {
+    const Rules &rules = get_rules<is_default>();
+    const TileRegion region = world.get_region();
+    RngBatch rng(world.rng);
+    for_each_tile(world, region, [&](std::uint16_t x, std::uint16_t y, auto is_interior) {
+        Tile &tile = world[x, y];
+        const bool is_polydividing =
+            is_evolution_enabled(enabled_evolutions, Evolution::Polydivision) &&
+            tile.cell.undergone_evolutions[Evolution::Polydivision];
+        if (
+            tile.active_evs.any(
+                Event::Synthesize,
+                Event::SynthesizeAndMoveToUp,
+                Event::SynthesizeAndMoveToDown,
+                Event::SynthesizeAndMoveToLeft,
+                Event::SynthesizeAndMoveToRight
+            ) ||
+            tile.cell.age < rules.reproduction_min_age ||
+            tile.cell.energy < rules.reproduction_min_energy ||
+            (is_polydividing && tile.cell.energy < rules.polydivision_min_energy) ||
+            !rng.chance(
+                is_polydividing ? rules.polydivision_odds : rules.reproduction_odds
+            )
+        ) {
+            return;
+        }
+        std::array<Tile *, 4> adjacent_tiles = find_adjacent_tiles<is_interior>(world, x, y);
+        const EvolutionInfo parent_evolutions = tile.cell.undergone_evolutions;
+        if (is_polydividing) {
+            // Only free tiles are divided into, so never the border tile
+            std::bitset<4> tile_selections;
+            for (std::uint8_t i = 0; i < 4; ++i) {
+                tile_selections[i] = adjacent_tiles[i]->cell.energy == 0;
+            }
+            tile.cell.energy /= tile_selections.count() + 1;
+            for (std::uint8_t i = 0; i < 4; ++i) {
+                if (tile_selections[i]) {
+                    tile.cell.utilized_evolutions += Evolution::Polydivision;
+                    tile.active_evs += Event::DivideUp + i;
+                    adjacent_tiles[i]->cell.age = 0;
+                    adjacent_tiles[i]->cell.energy = tile.cell.energy;
+                    for (std::uint8_t j = 0; j < Evolution::COUNT; ++j) {
+                        if (tile.cell.undergone_evolutions[j] && rng.chance(2)) {
+                            adjacent_tiles[i]->cell.undergone_evolutions += j;
+                        }
+                    }
+                    world.give_birth(adjacent_tiles[i]->cell, tile.cell.id);
+                    adjacent_tiles[i]->active_evs += Event::SpawnUp + i;
+                }
             }
-            bool regressive_evolution_happened = false;
             for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
-                if (
-                    tile.cell.undergone_evolutions[i] &&
-                    !tile.cell.utilized_evolutions[i] &&
-                    rng::chance(EVOLUTIONS[i].loss_prob)
-                ) {
+                if (tile.cell.undergone_evolutions[i] && !rng.chance(2)) {
                     tile.cell.undergone_evolutions -= i;
-                    regressive_evolution_happened = true;
                 }
             }
+            if (tile.cell.undergone_evolutions.data != parent_evolutions.data) {
+                world.record(LineageEvent::Evolutions, tile.cell);
+            }
+            return;
+        }
+        // Likewise only a free tile is selected and divided into
+        Tile *selected_tile = nullptr;
+        std::uint8_t direction = 0;
+        for (std::uint8_t i = 0; i < 4; ++i) {
             if (
-                regressive_evolution_happened ||
-                tile.active_evs.any(
-                    Event::Synthesize,
-                    Event::SynthesizeAndMoveToUp,
-                    Event::SynthesizeAndMoveToDown,
-                    Event::SynthesizeAndMoveToLeft,
-                    Event::SynthesizeAndMoveToRight
+                adjacent_tiles[i]->cell.energy == 0 &&
+                (
+                    !selected_tile ||
+                    adjacent_tiles[i]->energy > selected_tile->energy
                 )
             ) {
-                continue;
+                selected_tile = adjacent_tiles[i];
+                direction = i;
             }
+        }
+        if (selected_tile) {
+            tile.active_evs += Event::DivideUp + direction;
+            tile.cell.energy /= 2;
+            selected_tile->cell.age = 0;
+            selected_tile->cell.energy = tile.cell.energy;
             for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
-                if (
-                    !tile.cell.undergone_evolutions[i] &&
-                    tile.cell.age >= EVOLUTIONS[i].eligibility &&
-                    tile.cell.energy >= EVOLUTIONS[i].cost &&
-                    rng::chance(EVOLUTIONS[i].acq_prob)
-                ) {
-                    tile.cell.ongoing_evolution = &EVOLUTIONS[i];
-                    break;
+                if (tile.cell.undergone_evolutions[i]) {
+                    if (rng.chance(2)) {
+                        selected_tile->cell.undergone_evolutions += i;
+                    }
+                    if (!rng.chance(2)) {
+                        tile.cell.undergone_evolutions -= i;
+                    }
                 }
             }
+            world.give_birth(selected_tile->cell, tile.cell.id);
+            if (tile.cell.undergone_evolutions.data != parent_evolutions.data) {
+                world.record(LineageEvent::Evolutions, tile.cell);
+            }
+            selected_tile->active_evs += Event::SpawnUp + direction;
         }
-    }
+    });
 }
 
-void advance() {
-    ++world.gen;
-    advance_age();
-    advance_harvesting();
-    advance_living();
-    advance_pulsing();
-    advance_instinct();
-    advance_reproduction();
-    advance_evolution();
+// Loses unused evolutions or starts acquiring a new one
+template <bool is_default, std::uint8_t enabled_evolutions, typename Generator>
+void evolve(World &world, Tile &tile, Generator &rng) {
+    const Rules &rules = get_rules<is_default>();
+    if (tile.cell.ongoing_evolution) {
+        return;
+    }
+    bool regressive_evolution_happened = false;
+    for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+        if (
+            tile.cell.undergone_evolutions[i] &&
+            !tile.cell.utilized_evolutions[i] &&
+            rng.chance(rules.evolutions[i].loss_prob)
+        ) {
+            tile.cell.undergone_evolutions -= i;
+            regressive_evolution_happened = true;
+        }
+    }
+    if (regressive_evolution_happened) {
+        world.record(LineageEvent::Evolutions, tile.cell);
+    }
+    if (
+        regressive_evolution_happened ||
+        tile.active_evs.any(
+            Event::Synthesize,
+            Event::SynthesizeAndMoveToUp,
+            Event::SynthesizeAndMoveToDown,
+            Event::SynthesizeAndMoveToLeft,
+            Event::SynthesizeAndMoveToRight
+        )
+    ) {
+        return;
+    }
+    for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+        if (
+            is_evolution_enabled(enabled_evolutions, i) &&
+            !tile.cell.undergone_evolutions[i] &&
+            tile.cell.age >= rules.evolutions[i].eligibility &&
+            tile.cell.energy >= rules.evolutions[i].cost &&
+            rng.chance(rules.evolutions[i].acq_prob)
+        ) {
+            tile.cell.ongoing_evolution = i + 1;
+            break;
+        }
+    }
 }
 
-std::uint32_t count_live_cells() noexcept {
-    std::uint32_t live_cell_count = 0;
+template <bool is_default, std::uint8_t enabled_evolutions>
+void advance_evolution(World &world) {
+    // The last pass, so it also summarizes the final state of each tile into the chunk index
+    // while the tile is still in cache
+    RngBatch rng(world.rng);
     for (std::uint16_t x = 0; x < world.w; ++x) {
         for (std::uint16_t y = 0; y < world.h; ++y) {
-            if (world[x, y].cell.energy != 0) {
-                ++live_cell_count;
+            Tile &tile = world[x, y];
+            evolve<is_default, enabled_evolutions>(world, tile, rng);
+            if (world.index) {
+                world.index->add(x, y, tile);
             }
         }
     }
-    return live_cell_count;
 }
 
-bool ux_creation() {
-    std::uint32_t
-        potential_w = std::numeric_limits<std::uint32_t>::max(),
-        potential_h = std::numeric_limits<std::uint32_t>::max();
-    if (gui::input_world_w.buffer.front() && gui::input_world_h.buffer.front()) {
-        potential_w = std::stoul(gui::input_world_w.get_value());
-        potential_h = std::stoul(gui::input_world_h.get_value());
-        gui::btn_generate.is_enabled =
-            potential_w >= 10 &&
-            potential_w <= std::numeric_limits<std::uint16_t>::max() &&
-            potential_h >= 10 &&
-            potential_h <= std::numeric_limits<std::uint16_t>::max();
-    } else {
-        gui::btn_generate.is_enabled = false;
-    }
-    if (gui::btn_generate.is_pressed) {
-        rng::srand(
-            gui::input_seed.buffer.front() ?
-                std::stoull(gui::input_seed.get_value()) :
-                static_cast<std::uint32_t>(std::time(nullptr))
-        );
-        if (!world.create(potential_w, potential_h)) {
-            gui::text_error.text = "Out of memory! Try making a smaller world!";
-            return true;
-        }
-        gui::input_world_w.clear();
-        gui::input_world_h.clear();
-        gui::input_seed.clear();
-        active_ux_state = UXState::Generation;
-        gui::text_generating.text = "Generating world... 0%";
-    }
-    return true;
+std::uint32_t get_thread_count() noexcept {
+    return options.threads ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
 }
 
-bool ux_generation() {
-    std::uint32_t tiles_generated = generate();
-    gui::text_generating.text = std::format(
-        "Generating world... {}%",
-        static_cast<std::uint32_t>(
-            static_cast<double>(tiles_generated) / world.size * 100
-        )
-    );
-    if (tiles_generated == world.size) {
-        active_ux_state = UXState::Sim;
+// Tasks are small multiples of the index chunks, so no two tasks ever update the same chunk
+// summary and a dense colony is still split across many tasks
+constexpr std::uint16_t TASK_W = CHUNK_SIZE, TASK_H = CHUNK_SIZE * 4;
+
+// A live cell runs every rule while a free tile is mostly skipped, so tasks are weighted by
+// their live cells first
+constexpr std::uint32_t TASK_LIVE_CELL_WEIGHT = 8;
+
+struct Birth {
+    std::uint32_t child, parent;
+};
+
+// How far each sweep of the synchronous passes reads around the tiles it updates. A domain's halo
+// goes stale from its outer edge inwards by these reaches, so one generation needs them all.
+constexpr std::array<std::uint16_t, 6> SWEEP_REACHES{ 0, 1, 1, 2, 1, 3 };
+
+constexpr std::uint16_t DOMAIN_HALO = 0 + 1 + 1 + 2 + 1 + 3;
+
+// Gives births in a domain's interior the cell ids they'd have had in a single world
+void give_domain_births(World &world, const std::vector<Birth> &births);
+
+struct AdvanceTask {
+    TileRegion region;
+    std::uint32_t live_cell_count;
+    // Births only get their cell ids once every task is done, in scan order
+    bool is_deferring_births;
+    std::vector<Birth> births;
+    std::uint32_t get_weight() const noexcept {
+        return
+            (region.x_end - region.x_begin) * (region.y_end - region.y_begin) +
+            live_cell_count * TASK_LIVE_CELL_WEIGHT;
     }
-    return true;
-}
+};
 
-constexpr std::uint8_t
-    ZOOM_SPEED    =   5,
-    MIN_ZOOM      =   5,
-    DEFAULT_ZOOM  =  25,
-    MAX_ZOOM      = 100,
-    MIN_SPEED     =   1,
-    DEFAULT_SPEED =   2,
-    MAX_SPEED     =   4;
+// What the threads of one node did since they started, a node being the whole machine without
+// NUMA placement
+struct NodeStats {
+    std::uint32_t node, thread_count;
+    std::uint64_t tile_updates, remote_task_count;
+    double busy_seconds;
+};
 
-bool ux_sim() {
-    static bool is_ready = false;
-    static std::uint32_t last_gen;
-    static std::uint8_t zoom, last_zoom, speed, last_speed;
-    static std::uint16_t animation_ms;
-    static std::int32_t cam_x, cam_y, drag_x, drag_y, tile_w, tile_h;
-    static bool is_dragging, has_acted, auto_mode, requires_clear, requires_report;
-    static std::uint32_t animation_tick;
-    if (!is_ready) {
-        last_gen = std::numeric_limits<std::uint32_t>::max();
-        zoom = DEFAULT_ZOOM;
-        last_zoom = 0;
-        speed = DEFAULT_SPEED;
-        last_speed = 0;
-        animation_ms = ANIMATION_MS / DEFAULT_SPEED;
-        cam_x = 0;
-        cam_y = 0;
-        drag_x = 0;
-        drag_y = 0;
-        tile_w = TILE_WIDTH * DEFAULT_ZOOM / 100;
-        tile_h = TILE_HEIGHT * DEFAULT_ZOOM / 100;
-        is_dragging = false;
-        has_acted = true;
-        auto_mode = false;
-        requires_clear = false;
-        requires_report = false;
-        animation_tick = 0;
-        gui::text_report_world_size.text =
-            std::format("World size: {}x{}", world.w, world.h);
-        gui::text_report_seed.text = std::format("Seed: {}", rng::seed);
-        is_ready = true;
+// Runs each sweep of the synchronous passes as tasks over the world on a pool of threads, the
+// calling one included. Every generation, the tasks are handed out as contiguous ranges of equal
+// weight, one per thread, and a thread that runs out steals half of what's left of another's.
+// With NUMA placement, each node owns a band of columns: their memory is moved to it, its threads
+// are pinned to it and start on its tasks, and they only steal across nodes once their own node
+// has run dry.
+class AdvanceScheduler {
+    // A thread's range of task indices, the first in the high half, taken from the front by the
+    // thread and from the back by thieves, along with what the thread has done so far
+    struct alignas(64) Worker {
+        std::atomic<std::uint64_t> range;
+        std::uint32_t node;
+        std::atomic<std::uint64_t> tile_updates, busy_time, remote_task_count;
+    };
+    static constexpr std::uint64_t pack(std::uint32_t begin, std::uint32_t end) noexcept {
+        return static_cast<std::uint64_t>(begin) << 32 | end;
     }
-    gui::icon_btn_start.is_enabled = !auto_mode;
-    gui::icon_btn_stop.is_enabled = auto_mode;
-    gui::icon_btn_step.is_enabled = !auto_mode && animation_tick == 0;
-    gui::icon_btn_zoom_in.is_enabled = zoom < MAX_ZOOM;
-    gui::icon_btn_zoom_out.is_enabled = zoom > MIN_ZOOM;
-    gui::icon_btn_speed_up.is_enabled = speed < MAX_SPEED;
-    gui::icon_btn_slow_down.is_enabled = speed > MIN_SPEED;
-    gui::icon_btn_quit.is_enabled = true;
-    if (gui::icon_btn_quit.is_pressed) {
-        is_ready = false;
-        world.destroy();
-        active_ux_state = UXState::Creation;
-        return true;
+    std::uint16_t w, h;
+    const Tile *tilemap;
+    std::vector<AdvanceTask> tasks;
+    std::uint32_t strip_task_count;
+    // No nodes without NUMA placement. Per node (or for the whole machine), its first thread and
+    // its first task, with an extra end at the back
+    std::vector<numa::Node> nodes;
+    std::vector<std::uint32_t> node_thread_begins, node_task_begins, splits, birth_cursors;
+    std::unique_ptr<Worker[]> workers;
+    std::uint32_t requested_thread_count, thread_count;
+    std::thread::id pinned_caller;
+    std::vector<std::jthread> threads;
+    std::atomic<std::uint32_t> sweep_serial, pending_thread_count;
+    std::atomic<bool> is_started, is_stopping;
+    void (*sweep)(const void *context, AdvanceTask &task);
+    const void *sweep_context;
+    std::uint32_t get_node_count() const noexcept {
+        return std::max<std::uint32_t>(nodes.size(), 1);
     }
-    std::int32_t mouse_x, mouse_y;
-    std::uint32_t mouse_state = SDL_GetMouseState(&mouse_x, &mouse_y);
-    const struct nk_rect gui_panel_controls_rect = gui::panel_controls.pos();
-    const std::int32_t y_bound = gui_panel_controls_rect.y + gui_panel_controls_rect.h;
-    const bool is_mouse_within_bounds =
-        mouse_x >= 0 &&
-        mouse_y >= y_bound &&
-        mouse_x < ctx.window_w &&
-        mouse_y < ctx.window_h;
-    if (
-        is_mouse_within_bounds &&
-        (
-            (ctx.scroll_y > 0 && zoom < MAX_ZOOM) ||
-            (ctx.scroll_y < 0 && zoom > MIN_ZOOM)
-        )
-    ) {
-        const std::uint8_t new_zoom =
-            zoom + (ctx.scroll_y < 0 ? -ZOOM_SPEED : ZOOM_SPEED);
-        const double factor = static_cast<double>(new_zoom) / zoom;
-        zoom = new_zoom;
-        cam_x = (cam_x - mouse_x) * factor + mouse_x;
-        cam_y = (cam_y - mouse_y + y_bound) * factor + mouse_y - y_bound;
+    bool pop(std::uint32_t thread, std::uint32_t &task) noexcept {
+        std::atomic<std::uint64_t> &range = workers[thread].range;
+        std::uint64_t value = range.load(std::memory_order_acquire);
+        while (static_cast<std::uint32_t>(value >> 32) < static_cast<std::uint32_t>(value)) {
+            const std::uint32_t begin = value >> 32;
+            if (
+                range.compare_exchange_weak(
+                    value,
+                    pack(begin + 1, static_cast<std::uint32_t>(value)),
+                    std::memory_order_acq_rel
+                )
+            ) {
+                task = begin;
+                return true;
+            }
+        }
+        return false;
     }
-    const std::uint32_t curr_tick = SDL_GetTicks();
-    const std::int32_t
-        disp_x = mouse_x - cam_x,
-        disp_y = mouse_y - y_bound - cam_y;
-    if (gui::icon_btn_start.is_pressed) {
-        if (!has_acted) {
-            auto_mode = true;
+    // Thieves only ever take from non-empty ranges, so the thief's own empty range can be
+    // refilled with a plain store
+    bool steal(std::uint32_t thread, std::uint32_t &task) noexcept {
+        for (const bool is_same_node : { true, false }) {
+            for (std::uint32_t i = 1; i < thread_count; ++i) {
+                Worker &victim = workers[(thread + i) % thread_count];
+                if ((victim.node == workers[thread].node) != is_same_node) {
+                    continue;
+                }
+                std::uint64_t value = victim.range.load(std::memory_order_acquire);
+                while (
+                    static_cast<std::uint32_t>(value >> 32) < static_cast<std::uint32_t>(value)
+                ) {
+                    const std::uint32_t
+                        begin = value >> 32,
+                        end = static_cast<std::uint32_t>(value),
+                        middle = end - (end - begin + 1) / 2;
+                    if (
+                        victim.range.compare_exchange_weak(
+                            value, pack(begin, middle), std::memory_order_acq_rel
+                        )
+                    ) {
+                        workers[thread].range.store(
+                            pack(middle + 1, end), std::memory_order_release
+                        );
+                        task = middle;
+                        return true;
+                    }
+                }
+            }
         }
-        has_acted = true;
-    } else if (gui::icon_btn_stop.is_pressed) {
-        if (!has_acted) {
-            auto_mode = false;
+        return false;
+    }
+    void work(std::uint32_t thread) {
+        Worker &worker = workers[thread];
+        const std::uint32_t
+            task_begin = node_task_begins[worker.node],
+            task_end = node_task_begins[worker.node + 1];
+        const auto start_time = std::chrono::steady_clock::now();
+        std::uint64_t tile_updates = 0, remote_task_count = 0;
+        std::uint32_t task;
+        while (pop(thread, task) || steal(thread, task)) {
+            const TileRegion &region = tasks[task].region;
+            tile_updates += (region.x_end - region.x_begin) * (region.y_end - region.y_begin);
+            remote_task_count += task < task_begin || task >= task_end;
+            sweep(sweep_context, tasks[task]);
         }
-        has_acted = true;
-    } else if (gui::icon_btn_step.is_pressed) {
-        if (!has_acted && animation_tick == 0) {
-            advance();
-            animation_tick = curr_tick;
+        worker.tile_updates.fetch_add(tile_updates, std::memory_order_relaxed);
+        worker.remote_task_count.fetch_add(remote_task_count, std::memory_order_relaxed);
+        worker.busy_time.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_time
+            ).count(),
+            std::memory_order_relaxed
+        );
+    }
+    void layout(World &world) {
+        w = world.w;
+        h = world.h;
+        tilemap = world.tilemap;
+        tasks.clear();
+        strip_task_count = (h + TASK_H - 1) / TASK_H;
+        // Nodes get bands of strips in proportion to their threads
+        const std::uint32_t strip_count = (w + TASK_W - 1) / TASK_W;
+        bool is_bound = true;
+        for (std::uint32_t i = 0; i < get_node_count(); ++i) {
+            const std::uint32_t
+                strip_begin = node_task_begins[i] / strip_task_count,
+                strip_end = static_cast<std::uint64_t>(strip_count) * node_thread_begins[i + 1] /
+                    thread_count;
+            node_task_begins[i + 1] = strip_end * strip_task_count;
+            if (nodes.empty() || strip_begin == strip_end) {
+                continue;
+            }
+            const std::size_t
+                offset = strip_begin * TASK_W * static_cast<std::size_t>(h),
+                size = std::min<std::size_t>(
+                    (strip_end - strip_begin) * TASK_W * static_cast<std::size_t>(h),
+                    world.size - offset
+                );
+            is_bound &= numa::bind(world.tilemap + offset, sizeof(Tile) * size, nodes[i].id);
+            if (world.back_tilemap) {
+                is_bound &=
+                    numa::bind(world.back_tilemap + offset, sizeof(Tile) * size, nodes[i].id);
+            }
         }
-        has_acted = true;
-    } else if (gui::icon_btn_zoom_in.is_pressed) {
-        if (!has_acted && zoom < MAX_ZOOM) {
-            const std::uint8_t new_zoom = zoom + ZOOM_SPEED;
-            const double factor = static_cast<double>(new_zoom) / zoom;
-            zoom = new_zoom;
-            const std::int32_t
-                center_x = ctx.window_w / 2,
-                center_y = (ctx.window_h - y_bound) / 2;
-            cam_x = (cam_x - center_x) * factor + center_x;
-            cam_y = (cam_y - center_y) * factor + center_y;
+        if (!is_bound) {
+            std::println(std::cerr, "[NUMA warning] Couldn't move the world to its nodes");
         }
-        has_acted = true;
-    } else if (gui::icon_btn_zoom_out.is_pressed) {
-        if (!has_acted && zoom > MIN_ZOOM) {
-            const std::uint8_t new_zoom = zoom - ZOOM_SPEED;
-            const double factor = static_cast<double>(new_zoom) / zoom;
-            zoom = new_zoom;
-            const std::int32_t
-                center_x = ctx.window_w / 2,
-                center_y = (ctx.window_h - y_bound) / 2;
-            cam_x = (cam_x - center_x) * factor + center_x;
-            cam_y = (cam_y - center_y) * factor + center_y;
+        for (std::uint32_t x = 0; x < w; x += TASK_W) {
+            for (std::uint32_t y = 0; y < h; y += TASK_H) {
+                AdvanceTask &task = tasks.emplace_back();
+                task.region = {
+                    static_cast<std::uint16_t>(x),
+                    static_cast<std::uint16_t>(std::min<std::uint32_t>(x + TASK_W, w)),
+                    static_cast<std::uint16_t>(y),
+                    static_cast<std::uint16_t>(std::min<std::uint32_t>(y + TASK_H, h))
+                };
+                task.is_deferring_births = true;
+                for (std::uint16_t tx = task.region.x_begin; tx < task.region.x_end; ++tx) {
+                    for (std::uint16_t ty = task.region.y_begin; ty < task.region.y_end; ++ty) {
+                        task.live_cell_count += world[tx, ty].cell.energy != 0;
+                    }
+                }
+            }
         }
-        has_acted = true;
-    } else if (gui::icon_btn_speed_up.is_pressed) {
-        if (!has_acted && speed < MAX_SPEED) {
-            speed <<= 1;
+        birth_cursors.resize(strip_task_count);
+    }
+    void start() {
+        thread_count = std::max(
+            requested_thread_count ? requested_thread_count : get_thread_count(), 1u
+        );
+        if (options.numa_placement == NumaPlacement::Partition) {
+            nodes = numa::find_nodes();
+            if (nodes.size() < 2) {
+                std::println(
+                    std::cerr, "[NUMA warning] Found a single node, threads stay unpinned"
+                );
+                nodes.clear();
+            }
+            thread_count = std::max<std::uint32_t>(thread_count, nodes.size());
         }
-        has_acted = true;
-    } else if (gui::icon_btn_slow_down.is_pressed) {
-        if (!has_acted && speed > MIN_SPEED) {
-            speed >>= 1;
+        // Threads are shared out in proportion to each node's CPUs, at least one each
+        std::uint64_t cpu_count = 0, total_cpu_count = 0;
+        for (const numa::Node &node : nodes) {
+            total_cpu_count += node.cpus.size();
         }
-        has_acted = true;
-    } else if (mouse_state & SDL_BUTTON(SDL_BUTTON_LEFT)) {
-        if (!has_acted) {
-            if (
-                is_mouse_within_bounds &&
-                disp_x >= 0 &&
-                disp_y >= 0 &&
-                disp_x < world.w * tile_w &&
-                disp_y < world.h * tile_h
-            ) {
-                world.ptr = &world[disp_x / tile_w, disp_y / tile_h];
-                requires_report = true;
-                requires_clear = true;
-            } else {
-                world.ptr = nullptr;
+        node_thread_begins.assign(get_node_count() + 1, 0);
+        node_task_begins.assign(get_node_count() + 1, 0);
+        for (std::uint32_t i = 1; i < nodes.size(); ++i) {
+            cpu_count += nodes[i - 1].cpus.size();
+            node_thread_begins[i] = i + (thread_count - nodes.size()) * cpu_count / total_cpu_count;
+        }
+        node_thread_begins.back() = thread_count;
+        workers = std::make_unique<Worker[]>(thread_count);
+        for (std::uint32_t i = 0; i < get_node_count(); ++i) {
+            for (std::uint32_t j = node_thread_begins[i]; j < node_thread_begins[i + 1]; ++j) {
+                workers[j].node = i;
             }
         }
-        has_acted = true;
-    } else {
-        has_acted = false;
+        splits.resize(thread_count + 1);
+        for (std::uint32_t i = 1; i < thread_count; ++i) {
+            threads.emplace_back([this, i]() {
+                if (!nodes.empty()) {
+                    numa::pin_thread(nodes[workers[i].node]);
+                }
+                std::uint32_t serial = 0;
+                for (;;) {
+                    sweep_serial.wait(serial, std::memory_order_acquire);
+                    serial = sweep_serial.load(std::memory_order_acquire);
+                    if (is_stopping.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    work(i);
+                    if (pending_thread_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        pending_thread_count.notify_one();
+                    }
+                }
+            });
+        }
+        is_started.store(true, std::memory_order_release);
     }
-    if (zoom != last_zoom) {
-        tile_w = TILE_WIDTH * zoom / 100;
-        tile_h = TILE_HEIGHT * zoom / 100;
-        gui::text_zoom.text = std::format("{}%", static_cast<std::uint32_t>(zoom));
-        last_zoom = zoom;
+public:
+    AdvanceScheduler() :
+        w{ 0 },
+        h{ 0 },
+        tilemap{ nullptr },
+        tasks{},
+        strip_task_count{ 0 },
+        nodes{},
+        node_thread_begins{},
+        node_task_begins{},
+        splits{},
+        birth_cursors{},
+        workers{},
+        requested_thread_count{ 0 },
+        thread_count{ 0 },
+        pinned_caller{},
+        threads{},
+        sweep_serial{ 0 },
+        pending_thread_count{ 0 },
+        is_started{ false },
+        is_stopping{ false },
+        sweep{ nullptr },
+        sweep_context{ nullptr } {}
+    // The threads are joined here, while the atomics they wake up to are still alive
+    ~AdvanceScheduler() {
+        is_stopping.store(true, std::memory_order_relaxed);
+        sweep_serial.fetch_add(1, std::memory_order_release);
+        sweep_serial.notify_all();
+        threads.clear();
     }
-    if (speed != last_speed) {
-        animation_ms = ANIMATION_MS / speed;
-        gui::text_speed.text = std::format("{}x", static_cast<std::uint32_t>(speed));
-        last_speed = speed;
+    // Runs on the given number of threads rather than --threads, if set before the first generation
+    void request_threads(std::uint32_t count) noexcept {
+        requested_thread_count = count;
     }
-    if (
-        is_mouse_within_bounds &&
-        (mouse_state & SDL_BUTTON(SDL_BUTTON_RIGHT))
-    ) {
-        if (!is_dragging) {
-            is_dragging = true;
-            drag_x = mouse_x;
-            drag_y = mouse_y;
-        } else {
-            std::int32_t dx = mouse_x - drag_x, dy = mouse_y - drag_y;
-            cam_x += dx;
-            cam_y += dy;
-            drag_x = mouse_x;
-            drag_y = mouse_y;
+    // Plans the tasks of a generation, or returns false if it has to run on the calling thread
+    bool begin(World &world) {
+        // Lineage records are appended as they happen, which only stays in order on one thread
+        if (world.lineage) {
+            return false;
         }
-    } else {
-        is_dragging = false;
-    }
-    if (auto_mode && animation_tick == 0) {
-        advance();
-        animation_tick = curr_tick;
-    } else if (animation_tick != 0 && curr_tick >= animation_tick + animation_ms) {
-        animation_tick = 0;
+        if (!thread_count) {
+            start();
+        }
+        if (thread_count == 1) {
+            return false;
+        }
+        if (!nodes.empty() && std::this_thread::get_id() != pinned_caller) {
+            numa::pin_thread(nodes[workers[0].node]);
+            pinned_caller = std::this_thread::get_id();
+        }
+        if (world.w != w || world.h != h || world.tilemap != tilemap) {
+            layout(world);
+        }
+        // Each node's tasks are split by weight over its threads
+        for (std::uint32_t i = 0; i < get_node_count(); ++i) {
+            const std::uint32_t
+                task_begin = node_task_begins[i],
+                task_end = node_task_begins[i + 1],
+                thread_begin = node_thread_begins[i],
+                node_thread_count = node_thread_begins[i + 1] - thread_begin;
+            std::uint64_t total_weight = 0, weight = 0;
+            for (std::uint32_t j = task_begin; j < task_end; ++j) {
+                total_weight += tasks[j].get_weight();
+            }
+            std::uint32_t thread = 1;
+            splits[thread_begin] = task_begin;
+            for (std::uint32_t j = task_begin; j < task_end && thread < node_thread_count; ++j) {
+                weight += tasks[j].get_weight();
+                while (
+                    thread < node_thread_count &&
+                    weight * node_thread_count >= total_weight * thread
+                ) {
+                    splits[thread_begin + thread++] = j + 1;
+                }
+            }
+            while (thread <= node_thread_count) {
+                splits[thread_begin + thread++] = task_end;
+            }
+        }
+        return true;
     }
-    if (world.gen != last_gen) {
-        gui::text_report_gen.text = std::format("Generation: {}", world.gen);
-        gui::text_report_live_cell_count.text =
-            std::format("Live cells: {}", count_live_cells());
-        if (world.ptr) {
-            requires_report = true;
+    template <typename Sweep>
+    void run(const Sweep &task_sweep) {
+        for (std::uint32_t i = 0; i < thread_count; ++i) {
+            workers[i].range.store(pack(splits[i], splits[i + 1]), std::memory_order_relaxed);
+        }
+        sweep = [](const void *context, AdvanceTask &task) {
+            (*static_cast<const Sweep *>(context))(task);
+        };
+        sweep_context = &task_sweep;
+        pending_thread_count.store(thread_count - 1, std::memory_order_relaxed);
+        sweep_serial.fetch_add(1, std::memory_order_release);
+        sweep_serial.notify_all();
+        work(0);
+        for (
+            std::uint32_t pending = pending_thread_count.load(std::memory_order_acquire);
+            pending != 0;
+            pending = pending_thread_count.load(std::memory_order_acquire)
+        ) {
+            pending_thread_count.wait(pending, std::memory_order_acquire);
         }
-        last_gen = world.gen;
     }
-    if (!world.ptr && requires_clear) {
-        gui::text_report_ptr_pos.text.clear();
-        gui::text_report_curr_tile_energy.text.clear();
-        gui::text_report_curr_cell_age.text.clear();
-        gui::text_report_curr_cell_energy.text.clear();
-        gui::text_report_curr_cell_undergone_evolutions.text.clear();
-        gui::text_report_curr_cell_ongoing_evolution.text.clear();
-        requires_clear = false;
-    } else if (world.ptr && requires_report) {
-        gui::text_report_ptr_pos.text =
-            std::format("XY: {}, {}", world.get_ptr_x(), world.get_ptr_y());
-        gui::text_report_curr_tile_energy.text =
-            std::format("Tile energy: {}", world.ptr->energy);
-        if (world.ptr->cell.energy != 0) {
-            gui::text_report_curr_cell_age.text =
-                std::format("Cell age: {}", world.ptr->cell.age);
-            gui::text_report_curr_cell_energy.text =
-                std::format("Cell energy: {}", world.ptr->cell.energy);
-            if (world.ptr->cell.undergone_evolutions.any()) {
-                gui::text_report_curr_cell_undergone_evolutions.text =
-                    "Undergone evolutions: ";
-                bool requires_comma = false;
-                for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
-                    if (world.ptr->cell.undergone_evolutions[i]) {
-                        gui::text_report_curr_cell_undergone_evolutions.text +=
-                            std::format(
-                                "{}{}",
-                                requires_comma ? ", " : "", EVOLUTIONS[i].name
-                            );
-                        requires_comma = true;
+    // Gives the deferred births their cell ids in the order a single sweep over the world would
+    // have, task by task down each strip of columns, so ids don't depend on the thread count
+    void end(World &world) {
+        for (std::uint32_t strip = 0; strip < tasks.size(); strip += strip_task_count) {
+            std::ranges::fill(birth_cursors, 0);
+            const TileRegion &region = tasks[strip].region;
+            for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+                const std::uint32_t column_end = (x + 1u) * world.h;
+                for (std::uint32_t i = 0; i < strip_task_count; ++i) {
+                    const std::vector<Birth> &births = tasks[strip + i].births;
+                    std::uint32_t &cursor = birth_cursors[i];
+                    for (; cursor < births.size() && births[cursor].child < column_end; ++cursor) {
+                        world.give_birth(
+                            world.tilemap[births[cursor].child].cell,
+                            world.back_tilemap[births[cursor].parent].cell.id
+                        );
                     }
                 }
-            } else {
-                gui::text_report_curr_cell_undergone_evolutions.text.clear();
             }
-            if (world.ptr->cell.ongoing_evolution) {
-                gui::text_report_curr_cell_ongoing_evolution.text =
-                    std::format(
-                        "Currently evolving: {} ({}%)",
-                        world.ptr->cell.ongoing_evolution->name,
-                        100 * world.ptr->cell.ongoing_evolution_progress /
-                        world.ptr->cell.ongoing_evolution->timescale
+            for (std::uint32_t i = 0; i < strip_task_count; ++i) {
+                tasks[strip + i].births.clear();
+            }
+        }
+    }
+    // Empty until generations have run on more than one thread
+    std::vector<NodeStats> get_node_stats() const {
+        std::vector<NodeStats> stats;
+        if (!is_started.load(std::memory_order_acquire) || thread_count == 1) {
+            return stats;
+        }
+        for (std::uint32_t i = 0; i < get_node_count(); ++i) {
+            NodeStats &node_stats = stats.emplace_back();
+            node_stats.node = nodes.empty() ? 0 : nodes[i].id;
+            node_stats.thread_count = node_thread_begins[i + 1] - node_thread_begins[i];
+            std::uint64_t busy_time = 0;
+            for (std::uint32_t j = node_thread_begins[i]; j < node_thread_begins[i + 1]; ++j) {
+                node_stats.tile_updates += workers[j].tile_updates.load(std::memory_order_relaxed);
+                node_stats.remote_task_count +=
+                    workers[j].remote_task_count.load(std::memory_order_relaxed);
+                busy_time += workers[j].busy_time.load(std::memory_order_relaxed);
+            }
+            node_stats.busy_seconds = busy_time / 1e9;
+        }
+        return stats;
+    }
+};
+
+AdvanceScheduler advance_scheduler;
+
+// Tile updates count every tile once per sweep, over the time the node's threads spent on them
+void print_node_throughput() {
+    for (const NodeStats &stats : advance_scheduler.get_node_stats()) {
+        std::println(
+            "Node {}: {} threads, {:.1f} M tile updates/s busy, {} tasks taken from other nodes",
+            stats.node,
+            stats.thread_count,
+            stats.busy_seconds > 0 ? stats.tile_updates / stats.busy_seconds / 1e6 : 0,
+            stats.remote_task_count
+        );
+    }
+}
+
+// Takes which tiles are occupied into the intents, for the harvests to count free neighbors from
+void advance_occupancy(World &world, const TileRegion &region) {
+    const Tile *tiles = world.tilemap;
+    std::uint8_t *occupancy = world.intents;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+            const std::uint32_t i = x * static_cast<std::uint32_t>(world.h) + y;
+            occupancy[i] = tiles[i].cell.energy != 0;
+        }
+    }
+}
+
+// Cells pick a free neighbor to move to from the tiles as they are
+template <std::uint8_t enabled_evolutions>
+void advance_instinct_intents(World &world, const TileRegion &region) {
+    const Tile *tiles = world.tilemap;
+    std::uint8_t *intents = world.intents;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+            const std::uint32_t i = x * static_cast<std::uint32_t>(world.h) + y;
+            const Tile &tile = tiles[i];
+            intents[i] = 0;
+            if (
+                !is_evolution_enabled(enabled_evolutions, Evolution::Motility) ||
+                tile.active_evs.any(Event::Synthesize) ||
+                !tile.cell.undergone_evolutions[Evolution::Motility] ||
+                tile.cell.energy < 3
+            ) {
+                continue;
+            }
+            const std::array<std::uint32_t, 4> adjacent_indices =
+                find_adjacent_indices(world, x, y);
+            std::uint32_t selected_energy = tile.energy;
+            std::uint8_t direction = NO_DIRECTION;
+            for (std::uint8_t j = 0; j < 4; ++j) {
+                const std::uint32_t adjacent_index = adjacent_indices[j];
+                if (
+                    adjacent_index != NO_TILE &&
+                    tiles[adjacent_index].cell.energy == 0 &&
+                    tiles[adjacent_index].energy > selected_energy
+                ) {
+                    selected_energy = tiles[adjacent_index].energy;
+                    direction = j;
+                }
+            }
+            if (direction != NO_DIRECTION) {
+                intents[i] = 1 << direction;
+            }
+        }
+    }
+}
+
+// Rebuilds every tile into the back tilemap from its own neighborhood: a free tile takes the
+// winning claim on it, and a cell only leaves its tile if its own claim won
+void advance_instinct_moves(World &world, const TileRegion &region) {
+    const Tile *tiles = world.tilemap;
+    const std::uint8_t *intents = world.intents;
+    Tile *back_tiles = world.back_tilemap;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+            const std::uint32_t i = x * static_cast<std::uint32_t>(world.h) + y;
+            const std::uint32_t key = world.get_tile_key(x, y);
+            const Tile &tile = tiles[i];
+            Tile &next_tile = back_tiles[i];
+            next_tile = tile;
+            if (tile.cell.energy == 0) {
+                const std::array<std::uint32_t, 4> adjacent_indices =
+                    find_adjacent_indices(world, x, y);
+                const std::uint8_t winner =
+                    find_claim_winner(world, tiles, intents, adjacent_indices, key);
+                if (winner == NO_DIRECTION) {
+                    continue;
+                }
+                const Tile &mover = tiles[adjacent_indices[winner]];
+                // As seen from the mover
+                const std::uint8_t direction = winner ^ 1;
+                next_tile.cell = mover.cell;
+                next_tile.cell.utilized_evolutions += Evolution::Motility;
+                next_tile.active_evs += (
+                    mover.active_evs[Event::Synthesize] ?
+                        Event::SynthesizeAndMoveToUp :
+                        Event::MoveToUp
+                ) + direction;
+            } else if (intents[i]) {
+                const std::uint8_t direction = std::countr_zero(intents[i]);
+                const std::array<std::uint32_t, 4> target_adjacent_indices =
+                    find_adjacent_indices(world, find_adjacent_indices(world, x, y)[direction]);
+                if (
+                    find_claim_winner(
+                        world,
+                        tiles,
+                        intents,
+                        target_adjacent_indices,
+                        find_adjacent_keys(world, key)[direction]
+                    ) != (direction ^ 1)
+                ) {
+                    continue;
+                }
+                if (tile.active_evs[Event::Synthesize]) {
+                    next_tile.active_evs -= Event::Synthesize;
+                    next_tile.active_evs += Event::SynthesizeAndMoveFromUp + direction;
+                } else {
+                    next_tile.active_evs += Event::MoveFromUp + direction;
+                }
+                next_tile.cell.age = 0;
+                next_tile.cell.energy = 0;
+                next_tile.cell.undergone_evolutions.clear();
+            }
+        }
+    }
+}
+
+template <std::uint8_t enabled_evolutions>
+bool is_polydividing(const Tile &tile) noexcept {
+    return
+        is_evolution_enabled(enabled_evolutions, Evolution::Polydivision) &&
+        tile.cell.undergone_evolutions[Evolution::Polydivision];
+}
+
+// Cells about to divide claim free neighbors from the back tilemap, like moves
+template <bool is_default, std::uint8_t enabled_evolutions>
+void advance_reproduction_intents(World &world, const TileRegion &region) {
+    const Rules &rules = get_rules<is_default>();
+    const std::uint32_t phase_key =
+        Rng::get_phase_key(world.rng.seed, world.gen, RNG_PHASE_REPRODUCTION);
+    const Tile *tiles = world.back_tilemap;
+    std::uint8_t *intents = world.intents;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+            const std::uint32_t i = x * static_cast<std::uint32_t>(world.h) + y;
+            const Tile &tile = tiles[i];
+            const bool is_tile_polydividing = is_polydividing<enabled_evolutions>(tile);
+            intents[i] = 0;
+            if (
+                tile.active_evs.any(
+                    Event::Synthesize,
+                    Event::SynthesizeAndMoveToUp,
+                    Event::SynthesizeAndMoveToDown,
+                    Event::SynthesizeAndMoveToLeft,
+                    Event::SynthesizeAndMoveToRight
+                ) ||
+                tile.cell.age < rules.reproduction_min_age ||
+                tile.cell.energy < rules.reproduction_min_energy ||
+                (is_tile_polydividing && tile.cell.energy < rules.polydivision_min_energy) ||
+                !Rng::for_tile(world.rng.seed, phase_key, world.get_tile_key(x, y)).chance(
+                    is_tile_polydividing ? rules.polydivision_odds : rules.reproduction_odds
+                )
+            ) {
+                continue;
+            }
+            const std::array<std::uint32_t, 4> adjacent_indices =
+                find_adjacent_indices(world, x, y);
+            std::uint8_t intent = INTENT_REPRODUCING, direction = NO_DIRECTION;
+            for (std::uint8_t j = 0; j < 4; ++j) {
+                const std::uint32_t adjacent_index = adjacent_indices[j];
+                if (adjacent_index == NO_TILE || tiles[adjacent_index].cell.energy != 0) {
+                    continue;
+                }
+                if (is_tile_polydividing) {
+                    intent |= 1 << j;
+                } else if (
+                    direction == NO_DIRECTION ||
+                    tiles[adjacent_index].energy > tiles[adjacent_indices[direction]].energy
+                ) {
+                    direction = j;
+                }
+            }
+            if (direction != NO_DIRECTION) {
+                intent |= 1 << direction;
+            }
+            intents[i] = intent;
+        }
+    }
+}
+
+// Directions from a reproducing tile whose claims won
+std::uint8_t find_won_directions(
+    const World &world,
+    const Tile *tiles,
+    const std::uint8_t *intents,
+    std::uint32_t i,
+    std::uint32_t key
+) noexcept {
+    const std::array<std::uint32_t, 4>
+        adjacent_indices = find_adjacent_indices(world, i),
+        adjacent_keys = find_adjacent_keys(world, key);
+    std::uint8_t won_directions = 0;
+    for (std::uint8_t j = 0; j < 4; ++j) {
+        if (
+            intents[i] >> j & 1 &&
+            find_claim_winner(
+                world,
+                tiles,
+                intents,
+                find_adjacent_indices(world, adjacent_indices[j]),
+                adjacent_keys[j]
+            ) == (j ^ 1)
+        ) {
+            won_directions |= 1 << j;
+        }
+    }
+    return won_directions;
+}
+
+// Divides cells into the tiles they won, back from the back tilemap into the tilemap, and
+// evolves every tile along the way
+template <bool is_default, std::uint8_t enabled_evolutions>
+void advance_reproduction_births(World &world, AdvanceTask &task) {
+    const TileRegion &region = task.region;
+    const Tile *tiles = world.back_tilemap;
+    const std::uint8_t *intents = world.intents;
+    const std::uint32_t phase_key =
+        Rng::get_phase_key(world.rng.seed, world.gen, RNG_PHASE_EVOLUTION);
+    // Every tile evolves, so the streams are set up a block of tiles down the column at a time.
+    // Keys run on past the column, the states of a last partial block are simply left unused.
+    std::array<std::uint32_t, Rng::TILE_STATE_BLOCK> rng_states;
+    task.live_cell_count = 0;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        for (std::uint16_t y = region.y_begin; y < region.y_end; ++y) {
+            const std::uint32_t i = x * static_cast<std::uint32_t>(world.h) + y;
+            const std::uint32_t key = world.get_tile_key(x, y);
+            const std::uint32_t block_offset = (y - region.y_begin) % Rng::TILE_STATE_BLOCK;
+            if (block_offset == 0) {
+                Rng::fill_tile_states(phase_key, key, rng_states);
+            }
+            Tile tile = tiles[i];
+            Rng rng{ .state = rng_states[block_offset], .seed = world.rng.seed };
+            if (tile.cell.energy == 0) {
+                const std::array<std::uint32_t, 4> adjacent_indices =
+                    find_adjacent_indices(world, x, y);
+                const std::uint8_t winner =
+                    find_claim_winner(world, tiles, intents, adjacent_indices, key);
+                if (winner != NO_DIRECTION) {
+                    const std::uint32_t parent_index = adjacent_indices[winner];
+                    const Cell &parent = tiles[parent_index].cell;
+                    const std::uint8_t parent_won_directions = find_won_directions(
+                        world,
+                        tiles,
+                        intents,
+                        parent_index,
+                        find_adjacent_keys(world, key)[winner]
                     );
+                    tile.cell.age = 0;
+                    tile.cell.energy = parent.energy / (std::popcount(parent_won_directions) + 1);
+                    for (std::uint8_t j = 0; j < Evolution::COUNT; ++j) {
+                        if (parent.undergone_evolutions[j] && rng.chance(2)) {
+                            tile.cell.undergone_evolutions += j;
+                        }
+                    }
+                    if (task.is_deferring_births) {
+                        task.births.push_back({ i, parent_index });
+                    } else {
+                        world.give_birth(tile.cell, parent.id);
+                    }
+                    tile.active_evs += Event::SpawnUp + (winner ^ 1);
+                }
+            } else if (intents[i] & INTENT_REPRODUCING) {
+                const std::uint8_t won_directions =
+                    find_won_directions(world, tiles, intents, i, key);
+                const EvolutionInfo parent_evolutions = tile.cell.undergone_evolutions;
+                const bool is_tile_polydividing = is_polydividing<enabled_evolutions>(tile);
+                if (is_tile_polydividing || won_directions) {
+                    tile.cell.energy /= std::popcount(won_directions) + 1;
+                    for (std::uint8_t j = 0; j < 4; ++j) {
+                        if (won_directions >> j & 1) {
+                            if (is_tile_polydividing) {
+                                tile.cell.utilized_evolutions += Evolution::Polydivision;
+                            }
+                            tile.active_evs += Event::DivideUp + j;
+                        }
+                    }
+                    for (std::uint8_t j = 0; j < Evolution::COUNT; ++j) {
+                        if (tile.cell.undergone_evolutions[j] && !rng.chance(2)) {
+                            tile.cell.undergone_evolutions -= j;
+                        }
+                    }
+                    if (tile.cell.undergone_evolutions.data != parent_evolutions.data) {
+                        world.record(LineageEvent::Evolutions, tile.cell);
+                    }
+                }
+            }
+            evolve<is_default, enabled_evolutions>(world, tile, rng);
+            world.tilemap[i] = tile;
+            task.live_cell_count += tile.cell.energy != 0;
+            if (world.index) {
+                world.index->add(x, y, tile);
+            }
+        }
+    }
+}
+
+template <bool is_default, std::uint8_t enabled_evolutions>
+void advance_passes(World &world) {
+    const TileRegion region = world.get_region();
+    advance_age<is_default>(world, region);
+    advance_harvesting<is_default, enabled_evolutions>(world, region);
+    advance_living<is_default>(world, region);
+    advance_pulsing<is_default>(world, region);
+    advance_instinct<enabled_evolutions>(world);
+    advance_reproduction<is_default, enabled_evolutions>(world);
+    advance_evolution<is_default, enabled_evolutions>(world);
+}
+
+// The same rules with moves and births resolved from the tiles as they were instead of in scan
+// order. The other passes only change their own tile, and harvesting only reads whether its
+// neighbors are occupied, from a snapshot taken before any of them runs.
+template <bool is_default, std::uint8_t enabled_evolutions>
+void advance_passes_synchronous(World &world) {
+    // Tiles of a sweep don't depend on each other, so every sweep runs as tasks that only wait
+    // for the previous sweep. The selected cell is followed by its id once all of them are done.
+    Tile *const selected_tile = world.ptr;
+    const std::uint64_t selected_cell_id =
+        selected_tile && selected_tile->cell.energy != 0 ? selected_tile->cell.id : 0;
+    world.ptr = nullptr;
+    AdvanceScheduler *scheduler =
+        world.scheduler && world.scheduler->begin(world) ? world.scheduler : nullptr;
+    // A domain only updates the tiles its interior still depends on, its interior grown by the
+    // reaches of the sweeps left to run
+    std::uint16_t margin = DOMAIN_HALO;
+    AdvanceTask task{ .is_deferring_births = world.domain != nullptr };
+    const auto run = [&](std::uint8_t sweep_index, const auto &sweep) {
+        margin -= SWEEP_REACHES[sweep_index];
+        if (scheduler) {
+            scheduler->run(sweep);
+            return;
+        }
+        task.region = world.interior.grow(margin, world.get_region());
+        sweep(task);
+    };
+    run(0, [&](AdvanceTask &task) {
+        advance_occupancy(world, task.region);
+    });
+    run(1, [&](AdvanceTask &task) {
+        advance_age<is_default>(world, task.region);
+        advance_harvesting<is_default, enabled_evolutions, true>(world, task.region);
+        advance_living<is_default>(world, task.region);
+        advance_pulsing<is_default>(world, task.region);
+    });
+    run(2, [&](AdvanceTask &task) {
+        advance_instinct_intents<enabled_evolutions>(world, task.region);
+    });
+    run(3, [&](AdvanceTask &task) {
+        advance_instinct_moves(world, task.region);
+    });
+    run(4, [&](AdvanceTask &task) {
+        advance_reproduction_intents<is_default, enabled_evolutions>(world, task.region);
+    });
+    run(5, [&](AdvanceTask &task) {
+        advance_reproduction_births<is_default, enabled_evolutions>(world, task);
+    });
+    if (scheduler) {
+        scheduler->end(world);
+    }
+    if (world.domain) {
+        give_domain_births(world, task.births);
+    }
+    // A cell moves at most one tile per generation
+    const auto is_selected_cell = [&](std::uint32_t i) {
+        return
+            i != NO_TILE &&
+            world.tilemap[i].cell.energy != 0 &&
+            world.tilemap[i].cell.id == selected_cell_id;
+    };
+    world.ptr = selected_tile;
+    if (selected_cell_id && !is_selected_cell(selected_tile - world.tilemap)) {
+        world.ptr = nullptr;
+        for (
+            const std::uint32_t i :
+            find_adjacent_indices(world, static_cast<std::uint32_t>(selected_tile - world.tilemap))
+        ) {
+            if (is_selected_cell(i)) {
+                world.ptr = &world.tilemap[i];
+            }
+        }
+    }
+}
+
+using AdvancePasses = void (*)(World &);
+
+template <bool is_synchronous, std::size_t... enabled_evolutions>
+constexpr std::array<AdvancePasses, sizeof...(enabled_evolutions)> make_custom_advance_passes(
+    std::index_sequence<enabled_evolutions...>
+) noexcept {
+    if constexpr (is_synchronous) {
+        return {{ &advance_passes_synchronous<false, enabled_evolutions>... }};
+    } else {
+        return {{ &advance_passes<false, enabled_evolutions>... }};
+    }
+}
+
+// One specialization per set of enabled evolutions, so disabled evolutions cost nothing
+constexpr std::array<AdvancePasses, 1 << Evolution::COUNT>
+    CUSTOM_ADVANCE_PASSES =
+        make_custom_advance_passes<false>(std::make_index_sequence<1 << Evolution::COUNT>{}),
+    CUSTOM_SYNCHRONOUS_ADVANCE_PASSES =
+        make_custom_advance_passes<true>(std::make_index_sequence<1 << Evolution::COUNT>{});
+
+AdvancePasses active_advance_passes = &advance_passes<true, DEFAULT_RULES.enabled_evolutions>;
+
+// Picks the passes of the update mode specialized for the loaded rules, falling back to the
+// constant-folded default passes whenever the rules match the defaults
+void select_advance_passes() noexcept {
+    if (options.update_mode == UpdateMode::Synchronous) {
+        active_advance_passes = rules == DEFAULT_RULES ?
+            &advance_passes_synchronous<true, DEFAULT_RULES.enabled_evolutions> :
+            CUSTOM_SYNCHRONOUS_ADVANCE_PASSES[rules.enabled_evolutions];
+    } else {
+        active_advance_passes = rules == DEFAULT_RULES ?
+            &advance_passes<true, DEFAULT_RULES.enabled_evolutions> :
+            CUSTOM_ADVANCE_PASSES[rules.enabled_evolutions];
+    }
+}
+
+void advance(World &world) {
+    world.begin_update();
+    ++world.gen;
+    if (world.index) {
+        world.index->begin_update();
+    }
+    active_advance_passes(world);
+    if (world.index) {
+        world.index->end_update();
+    }
+    if (world.stream) {
+        world.stream->publish(world);
+    }
+    world.end_update();
+}
+
+std::uint32_t count_live_cells(World &world) noexcept {
+    if (world.index) {
+        return world.index->get_summary().live_cell_count;
+    }
+    std::uint32_t live_cell_count = 0;
+    for (std::uint16_t x = 0; x < world.w; ++x) {
+        for (std::uint16_t y = 0; y < world.h; ++y) {
+            if (world[x, y].cell.energy != 0) {
+                ++live_cell_count;
+            }
+        }
+    }
+    return live_cell_count;
+}
+
+struct PopulationStats {
+    std::uint32_t live_cell_count;
+    std::array<std::uint32_t, Evolution::COUNT> evolved_cell_counts;
+};
+
+PopulationStats count_population(World &world) noexcept {
+    PopulationStats stats{};
+    for (std::uint16_t x = 0; x < world.w; ++x) {
+        for (std::uint16_t y = 0; y < world.h; ++y) {
+            const Cell &cell = world[x, y].cell;
+            if (cell.energy == 0) {
+                continue;
+            }
+            ++stats.live_cell_count;
+            for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+                stats.evolved_cell_counts[i] += cell.undergone_evolutions[i];
+            }
+        }
+    }
+    return stats;
+}
+
+template <typename T, std::uint32_t capacity>
+class BoundedQueue {
+    static_assert(std::has_single_bit(capacity));
+    struct Slot {
+        std::atomic<std::uint32_t> sequence;
+        T value;
+    };
+    std::array<Slot, capacity> slots;
+    alignas(64) std::atomic<std::uint32_t> head;
+    alignas(64) std::atomic<std::uint32_t> tail;
+public:
+    BoundedQueue() : slots{}, head{ 0 }, tail{ 0 } {
+        for (std::uint32_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    bool push(const T &value) noexcept {
+        std::uint32_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots[pos & (capacity - 1)];
+            const std::int32_t diff = static_cast<std::int32_t>(
+                slot.sequence.load(std::memory_order_acquire) - pos
+            );
+            if (diff == 0) {
+                if (
+                    head.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed
+                    )
+                ) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
             } else {
-                gui::text_report_curr_cell_ongoing_evolution.text.clear();
+                pos = head.load(std::memory_order_relaxed);
             }
-        } else {
-            gui::text_report_curr_cell_age.text.clear();
-            gui::text_report_curr_cell_energy.text.clear();
-            gui::text_report_curr_cell_undergone_evolutions.text.clear();
-            gui::text_report_curr_cell_ongoing_evolution.text.clear();
         }
-        requires_report = false;
     }
-    if (
-        ctx.window_w > world.w * tile_w ||
-        (cam_x > 0 && cam_x < -(world.w * tile_w - ctx.window_w))
-    ) {
-        cam_x = -(world.w * tile_w - ctx.window_w) / 2;
-    } else if (cam_x > 0) {
-        cam_x = 0;
-    } else if (cam_x < -(world.w * tile_w - ctx.window_w)) {
-        cam_x = -(world.w * tile_w - ctx.window_w);
+    bool pop(T &value) noexcept {
+        std::uint32_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots[pos & (capacity - 1)];
+            const std::int32_t diff = static_cast<std::int32_t>(
+                slot.sequence.load(std::memory_order_acquire) - (pos + 1)
+            );
+            if (diff == 0) {
+                if (
+                    tail.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed
+                    )
+                ) {
+                    value = slot.value;
+                    slot.sequence.store(pos + capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
     }
-    if (
-        ctx.window_h - y_bound > world.h * tile_h ||
-        (cam_y > 0 && cam_y < -(world.h * tile_h - ctx.window_h + y_bound))
+};
+
+template <typename T>
+class TripleBuffer {
+    static constexpr std::uint8_t INDEX_MASK = 0b011, DIRTY = 0b100;
+    std::array<T, 3> buffers;
+    std::atomic<std::uint8_t> middle;
+    std::uint8_t back, front;
+public:
+    TripleBuffer() : buffers{}, middle{ 1 }, back{ 0 }, front{ 2 } {}
+    T &get_back() noexcept {
+        return buffers[back];
+    }
+    const T &get_front() const noexcept {
+        return buffers[front];
+    }
+    void publish() noexcept {
+        back = middle.exchange(back | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    bool acquire() noexcept {
+        if (!(middle.load(std::memory_order_relaxed) & DIRTY)) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    void reset() {
+        buffers = {};
+        middle.store(1, std::memory_order_relaxed);
+        back = 0;
+        front = 2;
+    }
+};
+
+struct ViewRegion {
+    std::uint16_t x_begin, y_begin, x_end, y_end, step;
+    std::uint16_t get_cols() const noexcept {
+        return step ? (x_end - x_begin + step - 1) / step : 0;
+    }
+    std::uint16_t get_rows() const noexcept {
+        return step ? (y_end - y_begin + step - 1) / step : 0;
+    }
+    bool contains(const ViewRegion &other) const noexcept {
+        return
+            step == other.step &&
+            x_begin <= other.x_begin &&
+            y_begin <= other.y_begin &&
+            x_end >= other.x_end &&
+            y_end >= other.y_end;
+    }
+};
+
+struct TileView {
+    std::uint32_t active_evs;
+    std::uint8_t tint, evolutions;
+    bool is_alive;
+    bool has_event(std::uint8_t ev) const noexcept {
+        return active_evs >> ev & 1;
+    }
+};
+
+std::uint8_t get_tint(const Tile &tile) noexcept {
+    return 0x02 * std::min(tile.energy, GENERATION_TILE_INIT_ENERGY_CAP + 1);
+}
+
+struct WorldView {
+    std::uint32_t serial, gen, live_cell_count;
+    bool is_fast_forwarding;
+    // Serial of the last processed command that carried one
+    std::uint32_t command_serial;
+    ViewRegion region;
+    std::vector<TileView> tiles;
+    bool has_ptr;
+    std::uint16_t ptr_x, ptr_y;
+    Tile ptr_tile;
+    // Bumped whenever a jump lands, so the camera only follows each jump once
+    std::uint32_t jump_serial;
+    std::uint16_t jump_x, jump_y;
+    // Copy of the chunk index's map level, each tile of the map spanning map_span world tiles.
+    // Refreshed only where it changed since this view last captured it.
+    std::uint16_t map_w, map_h, map_span;
+    std::uint32_t map_serial;
+    std::vector<RegionSummary> map;
+    std::vector<std::uint32_t> map_update_serials;
+    const TileView *find(std::uint16_t x, std::uint16_t y) const noexcept {
+        if (
+            x < region.x_begin || x >= region.x_end ||
+            y < region.y_begin || y >= region.y_end ||
+            (x - region.x_begin) % region.step != 0 ||
+            (y - region.y_begin) % region.step != 0
+        ) {
+            return nullptr;
+        }
+        return &tiles[
+            (x - region.x_begin) / region.step * region.get_rows() +
+            (y - region.y_begin) / region.step
+        ];
+    }
+    void capture(std::uint32_t new_live_cell_count, const ViewRegion &new_region) {
+        ++serial;
+        gen = world.gen;
+        live_cell_count = new_live_cell_count;
+        region = new_region;
+        tiles.resize(region.get_cols() * region.get_rows());
+        TileView *tile_view = tiles.data();
+        for (std::uint16_t x = region.x_begin; x < region.x_end; x += region.step) {
+            for (std::uint16_t y = region.y_begin; y < region.y_end; y += region.step) {
+                const Tile &tile = world[x, y];
+                tile_view->active_evs = tile.active_evs.data.to_ulong();
+                tile_view->tint = get_tint(tile);
+                tile_view->evolutions = tile.cell.undergone_evolutions.data.to_ulong();
+                tile_view->is_alive = tile.cell.energy != 0;
+                ++tile_view;
+            }
+        }
+        has_ptr = world.ptr;
+        if (has_ptr) {
+            ptr_x = world.get_ptr_x();
+            ptr_y = world.get_ptr_y();
+            ptr_tile = *world.ptr;
+        }
+        if (world.index) {
+            capture_map(*world.index);
+        }
+    }
+    void capture_map(const ChunkIndex &index) {
+        const std::size_t level_idx = index.get_map_level();
+        const ChunkIndex::Level &level = index.get_level(level_idx);
+        if (level.w != map_w || level.h != map_h) {
+            map_w = level.w;
+            map_h = level.h;
+            map = level.summaries;
+            map_update_serials = level.update_serials;
+        } else {
+            for (std::size_t i = 0; i < map.size(); ++i) {
+                if (level.update_serials[i] > map_serial) {
+                    map[i] = level.summaries[i];
+                    map_update_serials[i] = level.update_serials[i];
+                }
+            }
+        }
+        map_span = CHUNK_SIZE << level_idx;
+        map_serial = index.get_update_serial();
+    }
+};
+
+enum class JumpTarget : std::uint8_t {
+    OldestCell,
+    RichestChunk,
+    EvolvedCell
+};
+
+struct Command {
+    enum class Type : std::uint8_t {
+        Start,
+        Stop,
+        Step,
+        SetSpeed,
+        Select,
+        Deselect,
+        SetRegion,
+        FastForward,
+        EndFastForward,
+        Jump,
+        // Saves the world to snapshot_<gen>.world
+        Snapshot
+    };
+    Type type;
+    std::uint8_t speed;
+    JumpTarget jump_target;
+    std::uint8_t evolution;
+    std::uint16_t x, y;
+    std::uint32_t gen;
+    ViewRegion region;
+    // Nonzero for commands whose effect the window waits to see in a view
+    std::uint32_t serial;
+};
+
+constexpr std::uint32_t COMMAND_QUEUE_CAPACITY = 1024;
+
+// Published along with every view for readers other than the window
+struct SimMetrics {
+    std::uint32_t gen, live_cell_count, snapshot_count, snapshot_error_count;
+    std::uint8_t speed;
+    bool is_auto_mode, is_fast_forwarding;
+    RegionSummary summary;
+};
+
+constexpr std::uint16_t FAST_FORWARD_BUDGET_MS = 16;
+
+class Simulation {
+    BoundedQueue<Command, COMMAND_QUEUE_CAPACITY> commands;
+    std::counting_semaphore<> wakeups;
+    TripleBuffer<WorldView> views;
+    TripleBuffer<SimMetrics> metrics;
+    std::jthread thread;
+    void run(std::stop_token stop_token) {
+        using Clock = std::chrono::steady_clock;
+        bool
+            auto_mode = false,
+            is_fast_forwarding = false,
+            requires_publish = true,
+            has_advanced = false;
+        std::uint32_t
+            fast_forward_target = 0,
+            command_serial = 0,
+            jump_serial = 0,
+            snapshot_count = 0,
+            snapshot_error_count = 0;
+        std::uint8_t speed = 1;
+        std::string snapshot_file;
+        TilePos jump_pos{};
+        std::optional<TilePos> found_pos;
+        // Cycles through the evolved cells one jump at a time
+        std::array<std::uint32_t, Evolution::COUNT> evolved_cell_jumps{};
+        std::chrono::milliseconds period{ ANIMATION_MS };
+        Clock::time_point next_advance = Clock::now();
+        std::uint32_t live_cell_count = count_live_cells(world);
+        ViewRegion region{};
+        while (!stop_token.stop_requested()) {
+            Command command;
+            while (commands.pop(command)) {
+                if (command.serial != 0) {
+                    command_serial = command.serial;
+                }
+                switch (command.type) {
+                case Command::Type::Start:
+                    auto_mode = true;
+                    next_advance = Clock::now();
+                    requires_publish = true;
+                    break;
+                case Command::Type::Stop:
+                    auto_mode = false;
+                    is_fast_forwarding = false;
+                    requires_publish = true;
+                    break;
+                case Command::Type::Step:
+                    if (!auto_mode && !is_fast_forwarding) {
+                        advance(world);
+                        live_cell_count = count_live_cells(world);
+                        requires_publish = true;
+                    }
+                    break;
+                case Command::Type::SetSpeed:
+                    speed = command.speed;
+                    period = std::chrono::milliseconds(ANIMATION_MS / speed);
+                    requires_publish = true;
+                    break;
+                case Command::Type::Select:
+                    world.ptr = &world[command.x, command.y];
+                    requires_publish = true;
+                    break;
+                case Command::Type::Deselect:
+                    world.ptr = nullptr;
+                    requires_publish = true;
+                    break;
+                case Command::Type::SetRegion:
+                    region = command.region;
+                    requires_publish = true;
+                    break;
+                case Command::Type::FastForward:
+                    if (command.gen == 0 || command.gen > world.gen) {
+                        is_fast_forwarding = true;
+                        fast_forward_target = command.gen;
+                    }
+                    requires_publish = true;
+                    break;
+                case Command::Type::EndFastForward:
+                    is_fast_forwarding = false;
+                    requires_publish = true;
+                    has_advanced = true;
+                    break;
+                case Command::Type::Jump:
+                    switch (command.jump_target) {
+                    case JumpTarget::OldestCell:
+                        found_pos = chunk_index.find_oldest_cell(world);
+                        break;
+                    case JumpTarget::RichestChunk:
+                        found_pos = chunk_index.find_richest_chunk(world);
+                        break;
+                    case JumpTarget::EvolvedCell:
+                        found_pos = chunk_index.find_evolved_cell(
+                            world,
+                            command.evolution,
+                            evolved_cell_jumps[command.evolution]++
+                        );
+                    }
+                    if (found_pos) {
+                        world.ptr = &world[found_pos->x, found_pos->y];
+                        jump_pos = *found_pos;
+                        ++jump_serial;
+                        requires_publish = true;
+                    }
+                    break;
+                case Command::Type::Snapshot:
+                    snapshot_file = std::format("snapshot_{:08}.world", world.gen);
+                    if (world.save(snapshot_file)) {
+                        ++snapshot_count;
+                    } else {
+                        std::println(
+                            std::cerr, "[Snapshot error] Couldn't write {}", snapshot_file
+                        );
+                        ++snapshot_error_count;
+                    }
+                    requires_publish = true;
+                }
+            }
+            if (is_fast_forwarding) {
+                const Clock::time_point deadline =
+                    Clock::now() + std::chrono::milliseconds(FAST_FORWARD_BUDGET_MS);
+                do {
+                    advance(world);
+                } while (
+                    (fast_forward_target == 0 || world.gen < fast_forward_target) &&
+                    Clock::now() < deadline
+                );
+                if (fast_forward_target != 0 && world.gen >= fast_forward_target) {
+                    is_fast_forwarding = false;
+                }
+                live_cell_count = count_live_cells(world);
+                requires_publish = true;
+                has_advanced = true;
+            } else if (auto_mode && Clock::now() >= next_advance) {
+                advance(world);
+                live_cell_count = count_live_cells(world);
+                requires_publish = true;
+                has_advanced = true;
+            }
+            if (requires_publish) {
+                WorldView &view = views.get_back();
+                view.capture(live_cell_count, region);
+                view.is_fast_forwarding = is_fast_forwarding;
+                view.command_serial = command_serial;
+                view.jump_serial = jump_serial;
+                view.jump_x = jump_pos.x;
+                view.jump_y = jump_pos.y;
+                views.publish();
+                metrics.get_back() = {
+                    .gen = world.gen,
+                    .live_cell_count = live_cell_count,
+                    .snapshot_count = snapshot_count,
+                    .snapshot_error_count = snapshot_error_count,
+                    .speed = speed,
+                    .is_auto_mode = auto_mode,
+                    .is_fast_forwarding = is_fast_forwarding,
+                    .summary = world.index ? world.index->get_summary() : RegionSummary{}
+                };
+                metrics.publish();
+                requires_publish = false;
+            }
+            if (has_advanced) {
+                next_advance = Clock::now() + period;
+                has_advanced = false;
+            }
+            if (is_fast_forwarding) {
+                wakeups.try_acquire();
+            } else if (auto_mode) {
+                wakeups.try_acquire_until(next_advance);
+            } else {
+                wakeups.acquire();
+            }
+        }
+    }
+public:
+    Simulation() : commands{}, wakeups{ 0 }, views{}, metrics{}, thread{} {}
+    ~Simulation() {
+        stop();
+    }
+    void start() {
+        views.reset();
+        metrics.reset();
+        thread = std::jthread([this](std::stop_token stop_token) {
+            run(stop_token);
+        });
+    }
+    void stop() {
+        if (!thread.joinable()) {
+            return;
+        }
+        thread.request_stop();
+        wakeups.release();
+        thread.join();
+        Command command;
+        while (commands.pop(command)) {}
+    }
+    // Returns false if the queue is full and the command was dropped
+    bool push(const Command &command) {
+        if (!commands.push(command)) {
+            return false;
+        }
+        wakeups.release();
+        return true;
+    }
+    bool acquire_view() noexcept {
+        return views.acquire();
+    }
+    const WorldView &get_view() const noexcept {
+        return views.get_front();
+    }
+    // Only for a single reader besides the window
+    const SimMetrics &get_metrics() noexcept {
+        metrics.acquire();
+        return metrics.get_front();
+    }
+};
+
+Simulation sim;
+
+bool ux_creation() {
+    std::uint32_t
+        potential_w = std::numeric_limits<std::uint32_t>::max(),
+        potential_h = std::numeric_limits<std::uint32_t>::max();
+    if (gui::input_world_w.buffer.front() && gui::input_world_h.buffer.front()) {
+        potential_w = std::stoul(gui::input_world_w.get_value());
+        potential_h = std::stoul(gui::input_world_h.get_value());
+        gui::btn_generate.is_enabled =
+            potential_w >= 10 &&
+            potential_w <= std::numeric_limits<std::uint16_t>::max() &&
+            potential_h >= 10 &&
+            potential_h <= std::numeric_limits<std::uint16_t>::max();
+    } else {
+        gui::btn_generate.is_enabled = false;
+    }
+    if (gui::btn_generate.is_pressed) {
+        world.rng.srand(
+            gui::input_seed.buffer.front() ?
+                std::stoull(gui::input_seed.get_value()) :
+                static_cast<std::uint32_t>(std::time(nullptr))
+        );
+        if (
+            !world.create(potential_w, potential_h, options.huge_pages, options.world_file)
+        ) {
+            gui::text_error.text = options.world_file.empty() ?
+                "Out of memory! Try making a smaller world or using a world file!" :
+                "Couldn't map the world file! Try making a smaller world!";
+            return true;
+        }
+        if (!options.lineage_file.empty()) {
+            if (!lineage_log.open(options.lineage_file, false)) {
+                world.destroy();
+                gui::text_error.text = "Couldn't open the lineage log!";
+                return true;
+            }
+            world.lineage = &lineage_log;
+        }
+        if (!options.stream_name.empty()) {
+            if (!state_stream.open(options.stream_name, world.w, world.h)) {
+                world.destroy();
+                gui::text_error.text = "Couldn't create the state stream!";
+                return true;
+            }
+            world.stream = &state_stream;
+        }
+        world.index = &chunk_index;
+        world.scheduler = &advance_scheduler;
+        gui::input_world_w.clear();
+        gui::input_world_h.clear();
+        gui::input_seed.clear();
+        active_ux_state = UXState::Generation;
+        gui::text_generating.text = "Generating world... 0%";
+        generator.start();
+    }
+    return true;
+}
+
+bool ux_generation() {
+    gui::btn_cancel.is_enabled = true;
+    if (gui::btn_cancel.is_pressed) {
+        generator.cancel();
+        world.destroy();
+        active_ux_state = UXState::Creation;
+        return true;
+    }
+    gui::text_generating.text = std::format(
+        "Generating world... {}%",
+        static_cast<std::uint32_t>(
+            static_cast<double>(generator.get_tiles_generated()) / world.size * 100
+        )
+    );
+    if (generator.finish()) {
+        active_ux_state = UXState::Sim;
+    }
+    return true;
+}
+
+constexpr std::uint8_t
+    ZOOM_SPEED    =   5,
+    MIN_ZOOM      =   5,
+    DEFAULT_ZOOM  =  25,
+    MAX_ZOOM      = 100,
+    MIN_SPEED     =   1,
+    DEFAULT_SPEED =   2,
+    MAX_SPEED     =   4;
+
+constexpr std::uint8_t MAX_OVERVIEW_LEVEL = 8;
+
+constexpr struct nk_color COLOR_OVERVIEW_CELL{ .r = 0xFF, .g = 0xFF, .b = 0xFF, .a = 0xFF };
+
+constexpr std::array<struct nk_color, Evolution::COUNT> COLOR_OVERVIEW_EVOLUTIONS{{
+    { .r = 0x14, .g = 0xB4, .b = 0xFF, .a = 0xFF },
+    { .r = 0xFF, .g = 0xD7, .b = 0x00, .a = 0xFF },
+    { .r = 0xFF, .g = 0x8C, .b = 0x00, .a = 0xFF }
+}};
+
+std::uint32_t get_overview_color(const TileView *tile_view) noexcept {
+    struct nk_color color = COLOR_OVERVIEW_CELL;
+    if (!tile_view) {
+        color = COLOR_BG;
+    } else if (tile_view->is_alive) {
+        for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+            if (tile_view->evolutions >> i & 1) {
+                color = COLOR_OVERVIEW_EVOLUTIONS[i];
+            }
+        }
+    } else {
+        const std::uint32_t alpha = tile_view->tint;
+        color.r = (COLOR_CUSTOM_QOL.r * alpha + COLOR_BG.r * (0xFF - alpha)) / 0xFF;
+        color.g = (COLOR_CUSTOM_QOL.g * alpha + COLOR_BG.g * (0xFF - alpha)) / 0xFF;
+        color.b = (COLOR_CUSTOM_QOL.b * alpha + COLOR_BG.b * (0xFF - alpha)) / 0xFF;
+    }
+    return
+        0xFF000000 |
+        static_cast<std::uint32_t>(color.r) << 16 |
+        static_cast<std::uint32_t>(color.g) << 8 |
+        color.b;
+}
+
+bool render_overview(
+    const WorldView &view,
+    std::uint16_t x_begin,
+    std::uint16_t y_begin,
+    std::uint16_t x_end,
+    std::uint16_t y_end,
+    std::uint16_t step,
+    const SDL_Rect &dstrect
+) {
+    const std::int32_t
+        w = (x_end - x_begin + step - 1) / step,
+        h = (y_end - y_begin + step - 1) / step;
+    if (w <= 0 || h <= 0) {
+        return true;
+    }
+    if (!ctx.reserve_overview(w, h)) {
+        return false;
+    }
+    SDL_Rect srcrect{ .x = 0, .y = 0, .w = w, .h = h };
+    void *pixels;
+    std::int32_t pitch;
+    if (SDL_LockTexture(ctx.overview_texture, &srcrect, &pixels, &pitch) != 0) {
+        return false;
+    }
+    for (std::int32_t i = 0; i < h; ++i) {
+        std::uint32_t *row = reinterpret_cast<std::uint32_t *>(
+            static_cast<std::uint8_t *>(pixels) + i * pitch
+        );
+        const std::uint16_t y = y_begin + i * step;
+        for (std::int32_t j = 0; j < w; ++j) {
+            row[j] = get_overview_color(view.find(x_begin + j * step, y));
+        }
+    }
+    SDL_UnlockTexture(ctx.overview_texture);
+    return SDL_RenderCopy(ctx.renderer, ctx.overview_texture, &srcrect, &dstrect) == 0;
+}
+
+constexpr std::uint8_t BACKGROUND_TINT_INVALID = 0xFF;
+
+struct BackgroundCache {
+    bool is_valid;
+    std::int32_t cam_x, cam_y, tile_w, tile_h, view_w, view_h;
+    std::uint16_t x_begin, y_begin, x_end, y_end;
+    std::vector<std::uint8_t> tints;
+};
+
+BackgroundCache background_cache{};
+
+// Queues a tile's background: the base color, the energy tint over it and the tile sprite on top
+void batch_background_tile(const SDL_Rect &srcrect, const SDL_Rect &dstrect, std::uint8_t tint) {
+    ctx.batch(
+        dstrect,
+        SDL_Color{
+            .r = COLOR_BG.r,
+            .g = COLOR_BG.g,
+            .b = COLOR_BG.b,
+            .a = COLOR_BG.a
+        }
+    );
+    if (tint != 0) {
+        ctx.batch(
+            dstrect,
+            SDL_Color{
+                .r = COLOR_CUSTOM_QOL.r,
+                .g = COLOR_CUSTOM_QOL.g,
+                .b = COLOR_CUSTOM_QOL.b,
+                .a = tint
+            }
+        );
+    }
+    ctx.batch(srcrect, dstrect);
+}
+
+// Queues the cells of a region with (0, 0) at the origin, still or, while a step is animating,
+// twitching and playing their events tick_diff milliseconds in
+void batch_tiles(
+    const WorldView &view,
+    std::uint16_t x_begin,
+    std::uint16_t y_begin,
+    std::uint16_t x_end,
+    std::uint16_t y_end,
+    std::int32_t origin_x,
+    std::int32_t origin_y,
+    std::int32_t tile_w,
+    std::int32_t tile_h,
+    std::optional<std::uint32_t> tick_diff,
+    std::uint8_t speed
+) {
+    SDL_Rect
+        srcrect{ .w = TILE_WIDTH, .h = TILE_HEIGHT },
+        dstrect{ .w = tile_w,     .h = tile_h      };
+    for (std::uint16_t x = x_begin; x < x_end; ++x) {
+        dstrect.x = static_cast<std::uint32_t>(x) * tile_w + origin_x;
+        for (std::uint16_t y = y_begin; y < y_end; ++y) {
+            dstrect.y = static_cast<std::uint32_t>(y) * tile_h + origin_y;
+            const TileView *tile_view = view.find(x, y);
+            if (!tile_view) {
+                continue;
+            }
+            if (!tick_diff) {
+                if (tile_view->is_alive) {
+                    select_still_frame(
+                        srcrect,
+                        Still::Cell
+                    );
+                    ctx.batch(srcrect, dstrect);
+                }
+            } else {
+                if (tile_view->active_evs == 0 && tile_view->is_alive) {
+                    select_animation_frame(
+                        srcrect,
+                        Animation::Twitch,
+                        *tick_diff,
+                        speed
+                    );
+                    ctx.batch(srcrect, dstrect);
+                }
+                for (std::uint8_t ev = 0; ev < Event::COUNT; ++ev) {
+                    if (tile_view->has_event(ev)) {
+                        select_animation_frame(
+                            srcrect,
+                            ev + EVENT_TO_ANIMATION_OFFSET,
+                            *tick_diff,
+                            speed
+                        );
+                        ctx.batch(srcrect, dstrect);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool render_background(
+    const WorldView &view,
+    std::int32_t cam_x,
+    std::int32_t cam_y,
+    std::int32_t tile_w,
+    std::int32_t tile_h,
+    std::int32_t y_bound,
+    std::uint16_t x_begin,
+    std::uint16_t y_begin,
+    std::uint16_t x_end,
+    std::uint16_t y_end
+) {
+    BackgroundCache &cache = background_cache;
+    // The view may itself be drawn into a recording
+    SDL_Texture *const target = SDL_GetRenderTarget(ctx.renderer);
+    const std::int32_t
+        view_w = ctx.window_w,
+        view_h = ctx.window_h - y_bound,
+        dx = cam_x - cache.cam_x,
+        dy = cam_y - cache.cam_y;
+    if (view_w != cache.view_w || view_h != cache.view_h) {
+        if (!ctx.create_background(view_w, view_h)) {
+            return false;
+        }
+        cache.is_valid = false;
+    }
+    if (
+        !cache.is_valid ||
+        tile_w != cache.tile_w ||
+        tile_h != cache.tile_h ||
+        std::abs(dx) >= view_w ||
+        std::abs(dy) >= view_h
+    ) {
+        if (
+            SDL_SetRenderTarget(ctx.renderer, ctx.background_textures[0]) != 0 ||
+            SDL_SetRenderDrawColor(
+                ctx.renderer,
+                COLOR_BG.r,
+                COLOR_BG.g,
+                COLOR_BG.b,
+                COLOR_BG.a
+            ) != 0 ||
+            SDL_RenderClear(ctx.renderer) != 0
+        ) {
+            return false;
+        }
+        cache.tints.assign(
+            (x_end - x_begin) * (y_end - y_begin),
+            BACKGROUND_TINT_INVALID
+        );
+    } else {
+        if (dx != 0 || dy != 0) {
+            SDL_Rect dstrect{ .x = dx, .y = dy, .w = view_w, .h = view_h };
+            if (
+                SDL_SetRenderTarget(ctx.renderer, ctx.background_textures[1]) != 0 ||
+                SDL_SetRenderDrawColor(
+                    ctx.renderer,
+                    COLOR_BG.r,
+                    COLOR_BG.g,
+                    COLOR_BG.b,
+                    COLOR_BG.a
+                ) != 0 ||
+                SDL_RenderClear(ctx.renderer) != 0 ||
+                SDL_RenderCopy(
+                    ctx.renderer, ctx.background_textures[0], nullptr, &dstrect
+                ) != 0
+            ) {
+                return false;
+            }
+            std::swap(ctx.background_textures[0], ctx.background_textures[1]);
+        } else if (SDL_SetRenderTarget(ctx.renderer, ctx.background_textures[0]) != 0) {
+            return false;
+        }
+        if (
+            dx != 0 || dy != 0 ||
+            x_begin != cache.x_begin || y_begin != cache.y_begin ||
+            x_end != cache.x_end || y_end != cache.y_end
+        ) {
+            std::vector<std::uint8_t> tints(
+                (x_end - x_begin) * (y_end - y_begin),
+                BACKGROUND_TINT_INVALID
+            );
+            const std::uint16_t cached_h = cache.y_end - cache.y_begin;
+            for (std::uint16_t x = x_begin; x < x_end; ++x) {
+                if (x <= cache.x_begin || x + 1 >= cache.x_end) {
+                    continue;
+                }
+                for (std::uint16_t y = y_begin; y < y_end; ++y) {
+                    if (y <= cache.y_begin || y + 1 >= cache.y_end) {
+                        continue;
+                    }
+                    tints[(x - x_begin) * (y_end - y_begin) + y - y_begin] =
+                        cache.tints[(x - cache.x_begin) * cached_h + y - cache.y_begin];
+                }
+            }
+            cache.tints = std::move(tints);
+        }
+    }
+    SDL_Rect
+        srcrect{ .w = TILE_WIDTH, .h = TILE_HEIGHT },
+        dstrect{ .w = tile_w,     .h = tile_h      };
+    select_still_frame(
+        srcrect,
+        Still::Tile
+    );
+    std::uint8_t *cached_tint = cache.tints.data();
+    for (std::uint16_t x = x_begin; x < x_end; ++x) {
+        dstrect.x = static_cast<std::uint32_t>(x) * tile_w + cam_x;
+        for (std::uint16_t y = y_begin; y < y_end; ++y, ++cached_tint) {
+            const TileView *tile_view = view.find(x, y);
+            if (!tile_view || *cached_tint == tile_view->tint) {
+                continue;
+            }
+            *cached_tint = tile_view->tint;
+            dstrect.y = static_cast<std::uint32_t>(y) * tile_h + cam_y;
+            batch_background_tile(srcrect, dstrect, tile_view->tint);
+        }
+    }
+    if (!ctx.flush() || SDL_SetRenderTarget(ctx.renderer, target) != 0) {
+        return false;
+    }
+    cache.is_valid = true;
+    cache.cam_x = cam_x;
+    cache.cam_y = cam_y;
+    cache.tile_w = tile_w;
+    cache.tile_h = tile_h;
+    cache.view_w = view_w;
+    cache.view_h = view_h;
+    cache.x_begin = x_begin;
+    cache.y_begin = y_begin;
+    cache.x_end = x_end;
+    cache.y_end = y_end;
+    dstrect = { .x = 0, .y = y_bound, .w = view_w, .h = view_h };
+    return SDL_RenderCopy(
+        ctx.renderer, ctx.background_textures[0], nullptr, &dstrect
+    ) == 0;
+}
+
+enum class Heatmap : std::uint8_t {
+    Off,
+    TileEnergy,
+    Density,
+    Age,
+    Motility,
+    Polydivision,
+    Energosynthesis
+};
+
+constexpr std::array<const char *, 7> HEATMAP_NAMES{{
+    "Off", "Tile energy", "Density", "Age", "Motility", "Polydivision", "Energosynthesis"
+}};
+
+constexpr struct nk_color COLOR_HEATMAP_AGE{ .r = 0xFF, .g = 0xFF, .b = 0x8C, .a = 0xFF };
+
+constexpr std::uint8_t HEATMAP_OVERLAY_ALPHA = 0xA0;
+
+constexpr std::int32_t MINIMAP_SIZE = 160;
+
+// Scales each map tile between the background and the heatmap's color: tile energy against the
+// generation cap, density as live cells per tile, age as the mean cell age against the age step of
+// the living cost, and evolutions as their prevalence among live cells
+std::uint32_t get_heatmap_color(const RegionSummary &summary, Heatmap heatmap) noexcept {
+    double value = 0.0;
+    struct nk_color color;
+    switch (heatmap) {
+    case Heatmap::Off:
+    case Heatmap::Density:
+        value = static_cast<double>(summary.live_cell_count) / summary.tile_count;
+        color = COLOR_OVERVIEW_CELL;
+        break;
+    case Heatmap::TileEnergy:
+        value =
+            static_cast<double>(summary.tile_energy) / summary.tile_count /
+            GENERATION_TILE_INIT_ENERGY_CAP;
+        color = COLOR_CUSTOM_QOL;
+        break;
+    case Heatmap::Age:
+        if (summary.live_cell_count != 0) {
+            value =
+                static_cast<double>(summary.cell_age_sum) / summary.live_cell_count /
+                rules.living_cost_age_step;
+        }
+        color = COLOR_HEATMAP_AGE;
+        break;
+    default:
+        const std::uint8_t i =
+            static_cast<std::uint8_t>(heatmap) - static_cast<std::uint8_t>(Heatmap::Motility);
+        if (summary.live_cell_count != 0) {
+            value = static_cast<double>(summary.evolved_cell_counts[i]) / summary.live_cell_count;
+        }
+        color = COLOR_OVERVIEW_EVOLUTIONS[i];
+    }
+    const std::uint32_t alpha = std::clamp(value, 0.0, 1.0) * 0xFF;
+    return
+        0xFF000000 |
+        (color.r * alpha + COLOR_BG.r * (0xFF - alpha)) / 0xFF << 16 |
+        (color.g * alpha + COLOR_BG.g * (0xFF - alpha)) / 0xFF << 8 |
+        (color.b * alpha + COLOR_BG.b * (0xFF - alpha)) / 0xFF;
+}
+
+struct HeatmapCache {
+    bool is_valid;
+    Heatmap heatmap;
+    std::uint16_t w, h;
+    std::uint32_t map_serial;
+    std::vector<std::uint32_t> pixels;
+};
+
+HeatmapCache heatmap_cache{};
+
+// Recolors only the map tiles that changed since the last upload, or all of them when the
+// heatmap or the map size changes
+bool update_heatmap(const WorldView &view, Heatmap heatmap) {
+    HeatmapCache &cache = heatmap_cache;
+    if (view.map_w != cache.w || view.map_h != cache.h || !ctx.heatmap_texture) {
+        if (!ctx.create_heatmap(view.map_w, view.map_h)) {
+            return false;
+        }
+        cache.is_valid = false;
+        cache.w = view.map_w;
+        cache.h = view.map_h;
+        cache.pixels.resize(cache.w * cache.h);
+    }
+    const bool is_full = !cache.is_valid || heatmap != cache.heatmap;
+    bool has_changed = false;
+    for (std::uint16_t x = 0; x < cache.w; ++x) {
+        for (std::uint16_t y = 0; y < cache.h; ++y) {
+            const std::uint32_t i = x * static_cast<std::uint32_t>(cache.h) + y;
+            if (is_full || view.map_update_serials[i] > cache.map_serial) {
+                cache.pixels[y * cache.w + x] = get_heatmap_color(view.map[i], heatmap);
+                has_changed = true;
+            }
+        }
+    }
+    if (
+        has_changed &&
+        SDL_UpdateTexture(
+            ctx.heatmap_texture,
+            nullptr,
+            cache.pixels.data(),
+            cache.w * sizeof(std::uint32_t)
+        ) != 0
+    ) {
+        return false;
+    }
+    cache.is_valid = true;
+    cache.heatmap = heatmap;
+    cache.map_serial = view.map_serial;
+    return true;
+}
+
+// Fits the whole world into the bottom right corner, above the version, keeping its aspect
+SDL_Rect get_minimap_rect(const WorldView &view) noexcept {
+    if (view.map_w == 0 || world.w == 0) {
+        return {};
+    }
+    const std::int32_t
+        world_size = std::max(world.w, world.h),
+        w = world.w * MINIMAP_SIZE / world_size,
+        h = world.h * MINIMAP_SIZE / world_size;
+    return {
+        .x = ctx.window_w - gui::ELEMENT_MARGIN - w,
+        .y = ctx.window_h - 2 * gui::ELEMENT_MARGIN - 2 * gui::TEXT_ELEMENT_HEIGHT - h,
+        .w = w,
+        .h = h
+    };
+}
+
+// Writes a little-endian 16-bit value, as GIF stores them
+void append_u16(std::vector<std::uint8_t> &bytes, std::uint16_t value) {
+    bytes.push_back(value & 0xFF);
+    bytes.push_back(value >> 8);
+}
+
+constexpr std::uint32_t
+    GIF_CLEAR_CODE = 256,
+    GIF_END_CODE = 257,
+    GIF_MAX_CODES = 4096,
+    GIF_TABLE_SIZE = 8191,
+    GIF_GRID_LEVELS = 4;
+
+// LZW-compresses 8-bit palette indices into GIF data sub-blocks
+void append_gif_lzw(std::vector<std::uint8_t> &bytes, const std::vector<std::uint8_t> &indices) {
+    std::vector<std::int32_t> table_keys(GIF_TABLE_SIZE, -1);
+    std::vector<std::uint16_t> table_codes(GIF_TABLE_SIZE);
+    std::vector<std::uint8_t> packed;
+    std::uint32_t bits = 0, bit_count = 0, code_size = 9, next_code = GIF_END_CODE + 1;
+    const auto emit = [&](std::uint32_t code) {
+        bits |= code << bit_count;
+        bit_count += code_size;
+        while (bit_count >= 8) {
+            packed.push_back(bits & 0xFF);
+            bits >>= 8;
+            bit_count -= 8;
+        }
+    };
+    emit(GIF_CLEAR_CODE);
+    std::uint32_t prefix = indices.front();
+    for (std::size_t i = 1; i < indices.size(); ++i) {
+        const std::int32_t key = prefix << 8 | indices[i];
+        std::uint32_t slot = static_cast<std::uint32_t>(key) * 2654435761u % GIF_TABLE_SIZE;
+        while (table_keys[slot] != -1 && table_keys[slot] != key) {
+            slot = (slot + 1) % GIF_TABLE_SIZE;
+        }
+        if (table_keys[slot] == key) {
+            prefix = table_codes[slot];
+            continue;
+        }
+        emit(prefix);
+        if (next_code < GIF_MAX_CODES) {
+            // Widened as soon as the next code no longer fits, one step ahead of the decoder
+            if (next_code == 1u << code_size) {
+                ++code_size;
+            }
+            table_keys[slot] = key;
+            table_codes[slot] = next_code++;
+        } else {
+            emit(GIF_CLEAR_CODE);
+            std::ranges::fill(table_keys, -1);
+            code_size = 9;
+            next_code = GIF_END_CODE + 1;
+        }
+        prefix = indices[i];
+    }
+    emit(prefix);
+    emit(GIF_END_CODE);
+    if (bit_count > 0) {
+        packed.push_back(bits & 0xFF);
+    }
+    bytes.push_back(8);
+    for (std::size_t i = 0; i < packed.size(); i += 0xFF) {
+        const std::size_t block_size = std::min<std::size_t>(packed.size() - i, 0xFF);
+        bytes.push_back(block_size);
+        bytes.insert(bytes.end(), packed.begin() + i, packed.begin() + i + block_size);
+    }
+    bytes.push_back(0);
+}
+
+// Quantizes a frame to its most common colors at 5 bits per channel, which is exact for the few
+// flat colors of the sim, and appends it as a GIF image with its own color table
+void append_gif_frame(
+    std::vector<std::uint8_t> &bytes,
+    const std::vector<std::uint32_t> &pixels,
+    std::int32_t w,
+    std::int32_t h,
+    std::uint16_t delay_cs
+) {
+    const auto get_bin = [](std::uint32_t pixel) -> std::uint16_t {
+        return (pixel >> 9 & 0x7C00) | (pixel >> 6 & 0x03E0) | (pixel >> 3 & 0x001F);
+    };
+    std::vector<std::uint32_t> bin_counts(1 << 15), bin_colors(1 << 15);
+    for (const std::uint32_t pixel : pixels) {
+        const std::uint16_t bin = get_bin(pixel);
+        ++bin_counts[bin];
+        bin_colors[bin] = pixel;
+    }
+    std::vector<std::uint16_t> bins;
+    for (std::uint32_t bin = 0; bin < bin_counts.size(); ++bin) {
+        if (bin_counts[bin] != 0) {
+            bins.push_back(bin);
+        }
+    }
+    // Beyond 256 colors, a coarse grid takes the last slots so that rare colors stay close
+    constexpr std::uint32_t GRID_SIZE = GIF_GRID_LEVELS * GIF_GRID_LEVELS * GIF_GRID_LEVELS;
+    const std::size_t popular_count = bins.size() <= 256 ? bins.size() : 256 - GRID_SIZE;
+    std::partial_sort(
+        bins.begin(),
+        bins.begin() + popular_count,
+        bins.end(),
+        [&](std::uint16_t a, std::uint16_t b) {
+            return bin_counts[a] > bin_counts[b];
+        }
+    );
+    std::array<std::uint32_t, 256> palette{};
+    std::size_t palette_size = 0;
+    for (; palette_size < popular_count; ++palette_size) {
+        palette[palette_size] = bin_colors[bins[palette_size]];
+    }
+    const auto get_level = [](std::uint32_t level) {
+        return (2 * level + 1) * 0x80 / GIF_GRID_LEVELS;
+    };
+    for (std::uint32_t i = 0; palette_size < 256; ++i, ++palette_size) {
+        palette[palette_size] =
+            get_level(i / (GIF_GRID_LEVELS * GIF_GRID_LEVELS)) << 16 |
+            get_level(i / GIF_GRID_LEVELS % GIF_GRID_LEVELS) << 8 |
+            get_level(i % GIF_GRID_LEVELS);
+    }
+    // Every bin maps to its nearest palette color, reusing the counts as the lookup table
+    for (const std::uint16_t bin : bins) {
+        const std::uint32_t color = bin_colors[bin];
+        std::uint32_t best_distance = std::numeric_limits<std::uint32_t>::max(), best_i = 0;
+        for (std::uint32_t i = 0; i < palette_size && best_distance != 0; ++i) {
+            const std::uint32_t palette_color = palette[i];
+            std::uint32_t distance = 0;
+            for (std::uint32_t shift = 0; shift < 24; shift += 8) {
+                const std::int32_t diff =
+                    static_cast<std::int32_t>(color >> shift & 0xFF) -
+                    static_cast<std::int32_t>(palette_color >> shift & 0xFF);
+                distance += diff * diff;
+            }
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_i = i;
+            }
+        }
+        bin_counts[bin] = best_i;
+    }
+    std::vector<std::uint8_t> indices(pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        indices[i] = bin_counts[get_bin(pixels[i])];
+    }
+    bytes.insert(bytes.end(), { 0x21, 0xF9, 0x04, 0x00 });
+    append_u16(bytes, delay_cs);
+    bytes.insert(bytes.end(), { 0x00, 0x00, 0x2C });
+    append_u16(bytes, 0);
+    append_u16(bytes, 0);
+    append_u16(bytes, w);
+    append_u16(bytes, h);
+    bytes.push_back(0x87);
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        const std::uint32_t color = palette[i];
+        bytes.insert(bytes.end(), {
+            static_cast<std::uint8_t>(color >> 16),
+            static_cast<std::uint8_t>(color >> 8),
+            static_cast<std::uint8_t>(color)
+        });
+    }
+    append_gif_lzw(bytes, indices);
+}
+
+enum class RecordingFormat : std::uint8_t {
+    Gif,
+    // Bare RGB24 frames, e.g. for ffmpeg -f rawvideo -pix_fmt rgb24
+    Raw
+};
+
+struct RecordedFrame {
+    std::uint16_t delay_cs;
+    std::vector<std::uint32_t> pixels;
+    std::vector<std::uint8_t> bytes;
+    std::atomic<bool> is_encoded;
+};
+
+constexpr std::uint32_t RECORDING_FPS = 25, RECORDING_QUEUE_CAPACITY = 16;
+
+// Encodes frames of the window on worker threads while a writer thread appends them to the file
+// in order. Frames are recycled through a fixed pool and dropped whenever the pool runs dry, so
+// recording never stalls the UI. Captured frames are drawn into a render target and only read
+// back at the next capture, once the GPU is long done with them.
+class Recorder {
+    RecordingFormat format;
+    std::string path;
+    std::ofstream file;
+    std::int32_t w, h, target_w, target_h;
+    std::uint32_t frame_count, dropped_frame_count, last_tick;
+    SDL_Texture *target;
+    SDL_Rect target_rect;
+    bool has_target_frame, is_capturing;
+    std::unique_ptr<RecordedFrame[]> frames;
+    BoundedQueue<RecordedFrame *, RECORDING_QUEUE_CAPACITY>
+        free_frames, pending_frames, written_frames;
+    std::counting_semaphore<> pending_count, written_count;
+    std::vector<std::jthread> encoders;
+    std::jthread writer;
+    std::atomic<bool> has_failed;
+    void encode() {
+        for (;;) {
+            pending_count.acquire();
+            // The count guarantees a frame, but another thread may not have published its slot
+            RecordedFrame *frame;
+            while (!pending_frames.pop(frame)) {
+                std::this_thread::yield();
+            }
+            // One null frame per thread marks the end
+            if (!frame) {
+                return;
+            }
+            frame->bytes.clear();
+            if (format == RecordingFormat::Gif) {
+                append_gif_frame(frame->bytes, frame->pixels, w, h, frame->delay_cs);
+            } else {
+                for (const std::uint32_t pixel : frame->pixels) {
+                    frame->bytes.insert(frame->bytes.end(), {
+                        static_cast<std::uint8_t>(pixel >> 16),
+                        static_cast<std::uint8_t>(pixel >> 8),
+                        static_cast<std::uint8_t>(pixel)
+                    });
+                }
+            }
+            frame->is_encoded.store(true, std::memory_order_release);
+            frame->is_encoded.notify_one();
+        }
+    }
+    void write() {
+        for (;;) {
+            written_count.acquire();
+            RecordedFrame *frame;
+            while (!written_frames.pop(frame)) {
+                std::this_thread::yield();
+            }
+            if (!frame) {
+                return;
+            }
+            frame->is_encoded.wait(false, std::memory_order_acquire);
+            file.write(reinterpret_cast<const char *>(frame->bytes.data()), frame->bytes.size());
+            if (!file) {
+                has_failed.store(true, std::memory_order_relaxed);
+            }
+            free_frames.push(frame);
+        }
+    }
+    // Reads back the frame waiting in the render target, which is shown for the given time
+    bool read_target(std::uint32_t duration_ms) {
+        has_target_frame = false;
+        RecordedFrame *frame;
+        if (!free_frames.pop(frame)) {
+            ++dropped_frame_count;
+            return true;
+        }
+        // The window may have shrunk since the recording started
+        if (target_rect.w < w || target_rect.h < h) {
+            std::ranges::fill(
+                frame->pixels,
+                0xFF000000 |
+                static_cast<std::uint32_t>(COLOR_BG.r) << 16 |
+                static_cast<std::uint32_t>(COLOR_BG.g) << 8 |
+                COLOR_BG.b
+            );
+        }
+        const SDL_Rect read_rect{
+            .x = target_rect.x,
+            .y = target_rect.y,
+            .w = std::min(target_rect.w, w),
+            .h = std::min(target_rect.h, h)
+        };
+        if (
+            read_rect.w > 0 &&
+            read_rect.h > 0 && (
+                SDL_SetRenderTarget(ctx.renderer, target) != 0 ||
+                SDL_RenderReadPixels(
+                    ctx.renderer,
+                    &read_rect,
+                    SDL_PIXELFORMAT_ARGB8888,
+                    frame->pixels.data(),
+                    w * sizeof(std::uint32_t)
+                ) != 0 ||
+                SDL_SetRenderTarget(ctx.renderer, nullptr) != 0
+            )
+        ) {
+            free_frames.push(frame);
+            return false;
+        }
+        frame->delay_cs = (duration_ms + 5) / 10;
+        frame->is_encoded.store(false, std::memory_order_relaxed);
+        ++frame_count;
+        pending_frames.push(frame);
+        pending_count.release();
+        written_frames.push(frame);
+        written_count.release();
+        return true;
+    }
+public:
+    Recorder() :
+        format{ RecordingFormat::Gif },
+        path{},
+        file{},
+        w{ 0 },
+        h{ 0 },
+        target_w{ 0 },
+        target_h{ 0 },
+        frame_count{ 0 },
+        dropped_frame_count{ 0 },
+        last_tick{ 0 },
+        target{ nullptr },
+        target_rect{},
+        has_target_frame{ false },
+        is_capturing{ false },
+        frames{},
+        free_frames{},
+        pending_frames{},
+        written_frames{},
+        pending_count{ 0 },
+        written_count{ 0 },
+        encoders{},
+        writer{},
+        has_failed{ false }
+    {}
+    ~Recorder() {
+        stop();
+    }
+    bool is_recording() const noexcept {
+        return file.is_open();
+    }
+    std::uint32_t get_frame_count() const noexcept {
+        return frame_count;
+    }
+    std::uint32_t get_dropped_frame_count() const noexcept {
+        return dropped_frame_count;
+    }
+    const std::string &get_path() const noexcept {
+        return path;
+    }
+    RecordingFormat get_format() const noexcept {
+        return format;
+    }
+    std::int32_t get_w() const noexcept {
+        return w;
+    }
+    std::int32_t get_h() const noexcept {
+        return h;
+    }
+    // Records frames of the given size as a GIF, or as raw video for any other extension
+    bool start(const std::string &new_path, std::int32_t new_w, std::int32_t new_h) {
+        path = new_path;
+        format = std::filesystem::path(path).extension() == ".gif" ?
+            RecordingFormat::Gif : RecordingFormat::Raw;
+        w = new_w;
+        h = new_h;
+        frame_count = 0;
+        dropped_frame_count = 0;
+        has_failed.store(false, std::memory_order_relaxed);
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        if (format == RecordingFormat::Gif) {
+            std::vector<std::uint8_t> header{ 'G', 'I', 'F', '8', '9', 'a' };
+            append_u16(header, w);
+            append_u16(header, h);
+            header.insert(header.end(), { 0x00, 0x00, 0x00 });
+            // Loops forever
+            header.insert(header.end(), { 0x21, 0xFF, 0x0B });
+            header.insert(header.end(), { 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0' });
+            header.insert(header.end(), { 0x03, 0x01, 0x00, 0x00, 0x00 });
+            file.write(reinterpret_cast<const char *>(header.data()), header.size());
+        }
+        // Leaves half the cores to the sim
+        const std::uint32_t encoder_count = std::clamp(
+            std::thread::hardware_concurrency() / 2, 1u, RECORDING_QUEUE_CAPACITY / 2
+        );
+        frames = std::make_unique<RecordedFrame[]>(2 * encoder_count);
+        for (std::uint32_t i = 0; i < 2 * encoder_count; ++i) {
+            frames[i].pixels.resize(static_cast<std::size_t>(w) * h);
+            free_frames.push(&frames[i]);
+        }
+        for (std::uint32_t i = 0; i < encoder_count; ++i) {
+            encoders.emplace_back([this]() {
+                encode();
+            });
+        }
+        writer = std::jthread([this]() {
+            write();
+        });
+        return true;
+    }
+    // Starts drawing the window into the render target, at most RECORDING_FPS times a second,
+    // after reading back the frame drawn there by the previous capture. The given area of the
+    // window is what gets recorded.
+    bool begin_capture(const SDL_Rect &rect, std::uint32_t tick) {
+        if (has_target_frame && tick - last_tick < 1000 / RECORDING_FPS) {
+            return true;
+        }
+        if (has_target_frame && !read_target(tick - last_tick)) {
+            return false;
+        }
+        const std::int32_t window_w = rect.x + rect.w, window_h = rect.y + rect.h;
+        if (!target || window_w != target_w || window_h != target_h) {
+            if (target) {
+                SDL_DestroyTexture(target);
+            }
+            target = SDL_CreateTexture(
+                ctx.renderer,
+                SDL_PIXELFORMAT_ARGB8888,
+                SDL_TEXTUREACCESS_TARGET,
+                window_w,
+                window_h
+            );
+            if (!target || SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE) != 0) {
+                return false;
+            }
+            target_w = window_w;
+            target_h = window_h;
+        }
+        if (
+            SDL_SetRenderTarget(ctx.renderer, target) != 0 ||
+            SDL_SetRenderDrawColor(
+                ctx.renderer,
+                COLOR_BG.r,
+                COLOR_BG.g,
+                COLOR_BG.b,
+                COLOR_BG.a
+            ) != 0 ||
+            SDL_RenderClear(ctx.renderer) != 0
+        ) {
+            return false;
+        }
+        target_rect = rect;
+        last_tick = tick;
+        is_capturing = true;
+        return true;
+    }
+    // Shows the captured frame in the window
+    bool end_capture() {
+        if (!is_capturing) {
+            return true;
+        }
+        is_capturing = false;
+        has_target_frame = true;
+        return
+            SDL_SetRenderTarget(ctx.renderer, nullptr) == 0 &&
+            SDL_RenderCopy(ctx.renderer, target, nullptr, nullptr) == 0;
+    }
+    // Waits for the frames in flight and finishes the file
+    bool stop() {
+        if (!is_recording()) {
+            return true;
+        }
+        // A frame still being drawn is dropped, while the last complete one is shown for as
+        // long as any other
+        if (is_capturing) {
+            is_capturing = false;
+            if (SDL_SetRenderTarget(ctx.renderer, nullptr) != 0) {
+                has_failed.store(true, std::memory_order_relaxed);
+            }
+        } else if (has_target_frame && !read_target(1000 / RECORDING_FPS)) {
+            has_failed.store(true, std::memory_order_relaxed);
+        }
+        has_target_frame = false;
+        // The queues may be full of frames until the threads make room for the end markers
+        for (std::size_t i = 0; i < encoders.size(); ++i) {
+            while (!pending_frames.push(nullptr)) {
+                std::this_thread::yield();
+            }
+            pending_count.release();
+        }
+        while (!written_frames.push(nullptr)) {
+            std::this_thread::yield();
+        }
+        written_count.release();
+        encoders.clear();
+        writer = {};
+        RecordedFrame *frame;
+        while (free_frames.pop(frame)) {}
+        frames.reset();
+        if (target) {
+            SDL_DestroyTexture(target);
+            target = nullptr;
+        }
+        if (format == RecordingFormat::Gif) {
+            file.put(0x3B);
+        }
+        file.close();
+        return !has_failed.load(std::memory_order_relaxed) && !file.fail();
+    }
+};
+
+Recorder recorder;
+
+// Records the world area below the control panel, as large as it is right now
+void start_recording(const std::string &path) {
+    const struct nk_rect panel_controls_rect = gui::panel_controls.pos();
+    const std::int32_t y_bound = panel_controls_rect.y + panel_controls_rect.h;
+    if (!recorder.start(path, ctx.window_w, std::max(ctx.window_h - y_bound, 1))) {
+        std::println(std::cerr, "[Recording error] Couldn't open {}", path);
+        return;
+    }
+    ctx.record_icon = ctx.record_icons[1];
+}
+
+void stop_recording() {
+    if (!recorder.is_recording()) {
+        return;
+    }
+    ctx.record_icon = ctx.record_icons[0];
+    if (!recorder.stop()) {
+        std::println(std::cerr, "[Recording error] Couldn't write {}", recorder.get_path());
+        return;
+    }
+    std::println(
+        "Recorded {} frames to {} ({} dropped)",
+        recorder.get_frame_count(),
+        recorder.get_path(),
+        recorder.get_dropped_frame_count()
+    );
+    if (recorder.get_format() == RecordingFormat::Raw) {
+        std::println(
+            "Play it with: ffplay -f rawvideo -pixel_format rgb24 -video_size {}x{} "
+            "-framerate {} {}",
+            recorder.get_w(),
+            recorder.get_h(),
+            RECORDING_FPS,
+            recorder.get_path()
+        );
+    }
+}
+
+// Captures the world area of the frame about to be drawn while recording
+bool begin_recording_frame() {
+    if (!recorder.is_recording()) {
+        return true;
+    }
+    const struct nk_rect panel_controls_rect = gui::panel_controls.pos();
+    const std::int32_t y_bound = panel_controls_rect.y + panel_controls_rect.h;
+    return recorder.begin_capture(
+        { .x = 0, .y = y_bound, .w = ctx.window_w, .h = ctx.window_h - y_bound },
+        SDL_GetTicks()
+    );
+}
+
+bool ux_sim() {
+    static bool is_ready = false;
+    static std::uint32_t last_gen;
+    static std::uint8_t
+        zoom, last_zoom, overview_level, last_overview_level, speed, last_speed;
+    static std::uint16_t animation_ms;
+    static std::int32_t cam_x, cam_y, drag_x, drag_y, tile_w, tile_h, zoom_div;
+    static bool
+        is_dragging,
+        has_acted,
+        auto_mode,
+        is_fast_forwarding,
+        is_step_pending,
+        requires_report;
+    static std::uint32_t animation_tick, last_jump_serial, sent_command_serial;
+    static ViewRegion requested_region;
+    static Heatmap heatmap;
+    if (!is_ready) {
+        last_gen = std::numeric_limits<std::uint32_t>::max();
+        zoom = DEFAULT_ZOOM;
+        last_zoom = 0;
+        overview_level = 0;
+        last_overview_level = 0;
+        speed = DEFAULT_SPEED;
+        last_speed = 0;
+        animation_ms = ANIMATION_MS / DEFAULT_SPEED;
+        cam_x = 0;
+        cam_y = 0;
+        drag_x = 0;
+        drag_y = 0;
+        tile_w = TILE_WIDTH * DEFAULT_ZOOM / 100;
+        tile_h = TILE_HEIGHT * DEFAULT_ZOOM / 100;
+        zoom_div = 1;
+        is_dragging = false;
+        has_acted = true;
+        auto_mode = false;
+        is_fast_forwarding = false;
+        is_step_pending = false;
+        requires_report = false;
+        animation_tick = 0;
+        last_jump_serial = 0;
+        sent_command_serial = 0;
+        requested_region = {};
+        heatmap = Heatmap::Off;
+        gui::text_report_world_size.text =
+            std::format("World size: {}x{}", world.w, world.h);
+        gui::text_report_seed.text = std::format("Seed: {}", world.rng.seed);
+        background_cache.is_valid = false;
+        heatmap_cache.is_valid = false;
+        sim.start();
+        if (!options.record_file.empty()) {
+            start_recording(options.record_file);
+        }
+        is_ready = true;
+    }
+    std::uint32_t run_to_gen = 0;
+    if (gui::input_run_to.buffer.front()) {
+        run_to_gen = std::min<std::uint64_t>(
+            std::stoull(gui::input_run_to.get_value()),
+            std::numeric_limits<std::uint32_t>::max()
+        );
+    }
+    gui::icon_btn_start.is_enabled = !auto_mode || is_fast_forwarding;
+    gui::icon_btn_stop.is_enabled = auto_mode || is_fast_forwarding;
+    gui::icon_btn_step.is_enabled =
+        !auto_mode && !is_fast_forwarding && animation_tick == 0 && !is_step_pending;
+    gui::icon_btn_record.is_enabled = true;
+    gui::btn_turbo.is_enabled = true;
+    gui::btn_turbo.text = is_fast_forwarding ? "Normal" : "Turbo";
+    gui::btn_run_to.is_enabled =
+        !is_fast_forwarding &&
+        last_gen != std::numeric_limits<std::uint32_t>::max() &&
+        run_to_gen > last_gen;
+    const bool
+        can_zoom_in = zoom < MAX_ZOOM,
+        can_zoom_out = zoom > MIN_ZOOM || overview_level < MAX_OVERVIEW_LEVEL;
+    gui::icon_btn_zoom_in.is_enabled = can_zoom_in;
+    gui::icon_btn_zoom_out.is_enabled = can_zoom_out;
+    gui::icon_btn_speed_up.is_enabled = speed < MAX_SPEED;
+    gui::icon_btn_slow_down.is_enabled = speed > MIN_SPEED;
+    gui::btn_jump_oldest.is_enabled = true;
+    gui::btn_jump_richest.is_enabled = true;
+    gui::btn_jump_motility.is_enabled =
+        is_evolution_enabled(rules.enabled_evolutions, Evolution::Motility);
+    gui::btn_jump_polydivision.is_enabled =
+        is_evolution_enabled(rules.enabled_evolutions, Evolution::Polydivision);
+    gui::btn_jump_energosynthesis.is_enabled =
+        is_evolution_enabled(rules.enabled_evolutions, Evolution::Energosynthesis);
+    gui::btn_heatmap.is_enabled = true;
+    gui::btn_heatmap.text = HEATMAP_NAMES[static_cast<std::uint8_t>(heatmap)];
+    gui::icon_btn_quit.is_enabled = true;
+    if (gui::icon_btn_quit.is_pressed) {
+        is_ready = false;
+        stop_recording();
+        sim.stop();
+        world.destroy();
+        active_ux_state = UXState::Creation;
+        return true;
+    }
+    std::int32_t mouse_x, mouse_y;
+    std::uint32_t mouse_state = SDL_GetMouseState(&mouse_x, &mouse_y);
+    const struct nk_rect gui_panel_controls_rect = gui::panel_controls.pos();
+    const std::int32_t y_bound = gui_panel_controls_rect.y + gui_panel_controls_rect.h;
+    const bool is_mouse_within_bounds =
+        mouse_x >= 0 &&
+        mouse_y >= y_bound &&
+        mouse_x < ctx.window_w &&
+        mouse_y < ctx.window_h;
+    const auto apply_zoom = [](
+        bool is_zooming_in,
+        std::int32_t anchor_x,
+        std::int32_t anchor_y
+    ) {
+        const double scale = static_cast<double>(zoom) / (1 << overview_level);
+        if (is_zooming_in) {
+            if (overview_level > 0) {
+                --overview_level;
+            } else {
+                zoom += ZOOM_SPEED;
+            }
+        } else {
+            if (zoom > MIN_ZOOM) {
+                zoom -= ZOOM_SPEED;
+            } else {
+                ++overview_level;
+            }
+        }
+        const double factor =
+            static_cast<double>(zoom) / (1 << overview_level) / scale;
+        cam_x = (cam_x - anchor_x) * factor + anchor_x;
+        cam_y = (cam_y - anchor_y) * factor + anchor_y;
+    };
+    if (
+        is_mouse_within_bounds &&
+        (
+            (ctx.scroll_y > 0 && can_zoom_in) ||
+            (ctx.scroll_y < 0 && can_zoom_out)
+        )
+    ) {
+        apply_zoom(ctx.scroll_y > 0, mouse_x, mouse_y - y_bound);
+    }
+    const std::uint32_t curr_tick = SDL_GetTicks();
+    const SDL_Rect minimap_rect = get_minimap_rect(sim.get_view());
+    const double minimap_scale =
+        static_cast<double>(minimap_rect.w) / std::max<std::int32_t>(world.w, 1);
+    const bool is_mouse_within_minimap =
+        mouse_x >= minimap_rect.x &&
+        mouse_y >= minimap_rect.y &&
+        mouse_x < minimap_rect.x + minimap_rect.w &&
+        mouse_y < minimap_rect.y + minimap_rect.h;
+    const std::int32_t
+        disp_x = mouse_x - cam_x,
+        disp_y = mouse_y - y_bound - cam_y;
+    if (gui::icon_btn_start.is_pressed) {
+        if (!has_acted) {
+            if (is_fast_forwarding) {
+                is_fast_forwarding = false;
+                sim.push({ .type = Command::Type::EndFastForward });
+            }
+            auto_mode = true;
+            sim.push({ .type = Command::Type::Start, .serial = ++sent_command_serial });
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_stop.is_pressed) {
+        if (!has_acted) {
+            auto_mode = false;
+            is_fast_forwarding = false;
+            sim.push({ .type = Command::Type::Stop, .serial = ++sent_command_serial });
+        }
+        has_acted = true;
+    } else if (gui::btn_turbo.is_pressed) {
+        if (!has_acted) {
+            sim.push({
+                .type = is_fast_forwarding ?
+                    Command::Type::EndFastForward :
+                    Command::Type::FastForward,
+                .serial = ++sent_command_serial
+            });
+            is_fast_forwarding = !is_fast_forwarding;
+        }
+        has_acted = true;
+    } else if (gui::btn_run_to.is_pressed) {
+        if (!has_acted) {
+            sim.push({
+                .type = Command::Type::FastForward,
+                .gen = run_to_gen,
+                .serial = ++sent_command_serial
+            });
+            gui::input_run_to.clear();
+            is_fast_forwarding = true;
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_step.is_pressed) {
+        if (!has_acted && animation_tick == 0 && !is_step_pending) {
+            is_step_pending = true;
+            sim.push({ .type = Command::Type::Step });
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_record.is_pressed) {
+        if (!has_acted) {
+            if (recorder.is_recording()) {
+                stop_recording();
+            } else {
+                start_recording(std::format("recording_{}.gif", std::time(nullptr)));
+            }
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_zoom_in.is_pressed) {
+        if (!has_acted && can_zoom_in) {
+            apply_zoom(true, ctx.window_w / 2, (ctx.window_h - y_bound) / 2);
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_zoom_out.is_pressed) {
+        if (!has_acted && can_zoom_out) {
+            apply_zoom(false, ctx.window_w / 2, (ctx.window_h - y_bound) / 2);
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_speed_up.is_pressed) {
+        if (!has_acted && speed < MAX_SPEED) {
+            speed <<= 1;
+        }
+        has_acted = true;
+    } else if (gui::icon_btn_slow_down.is_pressed) {
+        if (!has_acted && speed > MIN_SPEED) {
+            speed >>= 1;
+        }
+        has_acted = true;
+    } else if (gui::btn_jump_oldest.is_pressed) {
+        if (!has_acted) {
+            sim.push({ .type = Command::Type::Jump, .jump_target = JumpTarget::OldestCell });
+        }
+        has_acted = true;
+    } else if (gui::btn_jump_richest.is_pressed) {
+        if (!has_acted) {
+            sim.push({ .type = Command::Type::Jump, .jump_target = JumpTarget::RichestChunk });
+        }
+        has_acted = true;
+    } else if (
+        gui::btn_jump_motility.is_pressed ||
+        gui::btn_jump_polydivision.is_pressed ||
+        gui::btn_jump_energosynthesis.is_pressed
+    ) {
+        if (!has_acted) {
+            sim.push({
+                .type = Command::Type::Jump,
+                .jump_target = JumpTarget::EvolvedCell,
+                .evolution = static_cast<std::uint8_t>(
+                    gui::btn_jump_motility.is_pressed ? Evolution::Motility :
+                    gui::btn_jump_polydivision.is_pressed ? Evolution::Polydivision :
+                    Evolution::Energosynthesis
+                )
+            });
+        }
+        has_acted = true;
+    } else if (gui::btn_heatmap.is_pressed) {
+        if (!has_acted) {
+            heatmap = static_cast<Heatmap>(
+                (static_cast<std::uint8_t>(heatmap) + 1) % HEATMAP_NAMES.size()
+            );
+        }
+        has_acted = true;
+    } else if ((mouse_state & SDL_BUTTON(SDL_BUTTON_LEFT)) && is_mouse_within_minimap) {
+        // Follows the mouse while held, so the minimap can be dragged across
+        cam_x = ctx.window_w / 2 - static_cast<std::int32_t>(
+            (mouse_x - minimap_rect.x) / minimap_scale * tile_w / zoom_div
+        );
+        cam_y = (ctx.window_h - y_bound) / 2 - static_cast<std::int32_t>(
+            (mouse_y - minimap_rect.y) / minimap_scale * tile_h / zoom_div
+        );
+        has_acted = true;
+    } else if (mouse_state & SDL_BUTTON(SDL_BUTTON_LEFT)) {
+        if (!has_acted) {
+            if (
+                is_mouse_within_bounds &&
+                disp_x >= 0 &&
+                disp_y >= 0 &&
+                disp_x < world.w * tile_w / zoom_div &&
+                disp_y < world.h * tile_h / zoom_div
+            ) {
+                sim.push({
+                    .type = Command::Type::Select,
+                    .x = static_cast<std::uint16_t>(disp_x * zoom_div / tile_w),
+                    .y = static_cast<std::uint16_t>(disp_y * zoom_div / tile_h)
+                });
+            } else {
+                sim.push({ .type = Command::Type::Deselect });
+            }
+        }
+        has_acted = true;
+    } else {
+        has_acted = false;
+    }
+    if (zoom != last_zoom || overview_level != last_overview_level) {
+        tile_w = TILE_WIDTH * zoom / 100;
+        tile_h = TILE_HEIGHT * zoom / 100;
+        zoom_div = 1 << overview_level;
+        gui::text_zoom.text = std::format(
+            "{:.3g}%", static_cast<double>(zoom) / zoom_div
+        );
+        last_zoom = zoom;
+        last_overview_level = overview_level;
+    }
+    if (speed != last_speed) {
+        animation_ms = ANIMATION_MS / speed;
+        gui::text_speed.text = std::format("{}x", static_cast<std::uint32_t>(speed));
+        sim.push({ .type = Command::Type::SetSpeed, .speed = speed });
+        last_speed = speed;
+    }
+    if (
+        is_mouse_within_bounds &&
+        (mouse_state & SDL_BUTTON(SDL_BUTTON_RIGHT))
+    ) {
+        if (!is_dragging) {
+            is_dragging = true;
+            drag_x = mouse_x;
+            drag_y = mouse_y;
+        } else {
+            std::int32_t dx = mouse_x - drag_x, dy = mouse_y - drag_y;
+            cam_x += dx;
+            cam_y += dy;
+            drag_x = mouse_x;
+            drag_y = mouse_y;
+        }
+    } else {
+        is_dragging = false;
+    }
+    if (sim.acquire_view()) {
+        const WorldView &view = sim.get_view();
+        // Until the sim has caught up with the last toggle, the view's flag predates it
+        if (view.command_serial == sent_command_serial) {
+            is_fast_forwarding = view.is_fast_forwarding;
+        }
+        if (view.jump_serial != last_jump_serial) {
+            cam_x = ctx.window_w / 2 - (view.jump_x * tile_w + tile_w / 2) / zoom_div;
+            cam_y =
+                (ctx.window_h - y_bound) / 2 - (view.jump_y * tile_h + tile_h / 2) / zoom_div;
+            last_jump_serial = view.jump_serial;
+        }
+        if (view.gen != last_gen) {
+            gui::text_report_gen.text = std::format("Generation: {}", view.gen);
+            gui::text_report_live_cell_count.text =
+                std::format("Live cells: {}", view.live_cell_count);
+            if (is_fast_forwarding) {
+                animation_tick = 0;
+            } else if (last_gen != std::numeric_limits<std::uint32_t>::max()) {
+                animation_tick = curr_tick;
+            }
+            is_step_pending = false;
+            last_gen = view.gen;
+        }
+        requires_report = true;
+    } else if (animation_tick != 0 && curr_tick >= animation_tick + animation_ms) {
+        animation_tick = 0;
+    }
+    const WorldView &view = sim.get_view();
+    if (!view.has_ptr && requires_report) {
+        gui::text_report_ptr_pos.text.clear();
+        gui::text_report_curr_tile_energy.text.clear();
+        gui::text_report_curr_cell_age.text.clear();
+        gui::text_report_curr_cell_energy.text.clear();
+        gui::text_report_curr_cell_undergone_evolutions.text.clear();
+        gui::text_report_curr_cell_ongoing_evolution.text.clear();
+        requires_report = false;
+    } else if (view.has_ptr && requires_report) {
+        const Tile &ptr_tile = view.ptr_tile;
+        gui::text_report_ptr_pos.text =
+            std::format("XY: {}, {}", view.ptr_x, view.ptr_y);
+        gui::text_report_curr_tile_energy.text =
+            std::format("Tile energy: {}", ptr_tile.energy);
+        if (ptr_tile.cell.energy != 0) {
+            gui::text_report_curr_cell_age.text =
+                std::format("Cell age: {}", ptr_tile.cell.age);
+            gui::text_report_curr_cell_energy.text =
+                std::format("Cell energy: {}", ptr_tile.cell.energy);
+            if (ptr_tile.cell.undergone_evolutions.any()) {
+                gui::text_report_curr_cell_undergone_evolutions.text =
+                    "Undergone evolutions: ";
+                bool requires_comma = false;
+                for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+                    if (ptr_tile.cell.undergone_evolutions[i]) {
+                        gui::text_report_curr_cell_undergone_evolutions.text +=
+                            std::format(
+                                "{}{}",
+                                requires_comma ? ", " : "", rules.evolutions[i].name
+                            );
+                        requires_comma = true;
+                    }
+                }
+            } else {
+                gui::text_report_curr_cell_undergone_evolutions.text.clear();
+            }
+            if (ptr_tile.cell.ongoing_evolution) {
+                gui::text_report_curr_cell_ongoing_evolution.text =
+                    std::format(
+                        "Currently evolving: {} ({}%)",
+                        ptr_tile.cell.get_ongoing_evolution().name,
+                        100 * ptr_tile.cell.ongoing_evolution_progress /
+                        ptr_tile.cell.get_ongoing_evolution().timescale
+                    );
+            } else {
+                gui::text_report_curr_cell_ongoing_evolution.text.clear();
+            }
+        } else {
+            gui::text_report_curr_cell_age.text.clear();
+            gui::text_report_curr_cell_energy.text.clear();
+            gui::text_report_curr_cell_undergone_evolutions.text.clear();
+            gui::text_report_curr_cell_ongoing_evolution.text.clear();
+        }
+        requires_report = false;
+    }
+    const std::int32_t
+        world_px_w = world.w * tile_w / zoom_div,
+        world_px_h = world.h * tile_h / zoom_div;
+    if (
+        ctx.window_w > world_px_w ||
+        (cam_x > 0 && cam_x < -(world_px_w - ctx.window_w))
+    ) {
+        cam_x = -(world_px_w - ctx.window_w) / 2;
+    } else if (cam_x > 0) {
+        cam_x = 0;
+    } else if (cam_x < -(world_px_w - ctx.window_w)) {
+        cam_x = -(world_px_w - ctx.window_w);
+    }
+    if (
+        ctx.window_h - y_bound > world_px_h ||
+        (cam_y > 0 && cam_y < -(world_px_h - ctx.window_h + y_bound))
+    ) {
+        cam_y = -(world_px_h - ctx.window_h + y_bound) / 2;
+    } else if (cam_y > 0) {
+        cam_y = 0;
+    } else if (cam_y < -(world_px_h - ctx.window_h + y_bound)) {
+        cam_y = -(world_px_h - ctx.window_h + y_bound);
+    }
+    SDL_Rect
+        srcrect{ .w = TILE_WIDTH, .h = TILE_HEIGHT },
+        dstrect{ .w = tile_w,     .h = tile_h      };
+    const std::uint16_t
+        visible_x_begin = std::clamp<std::int32_t>(
+            -cam_x * zoom_div / tile_w, 0, world.w
+        ),
+        visible_y_begin = std::clamp<std::int32_t>(
+            -cam_y * zoom_div / tile_h, 0, world.h
+        ),
+        visible_x_end = std::clamp<std::int32_t>(
+            ((ctx.window_w - cam_x) * zoom_div + tile_w - 1) / tile_w, 0, world.w
+        ),
+        visible_y_end = std::clamp<std::int32_t>(
+            ((ctx.window_h - y_bound - cam_y) * zoom_div + tile_h - 1) / tile_h,
+            0,
+            world.h
+        );
+    const std::uint16_t step = std::max(zoom_div / tile_w, 1);
+    const ViewRegion visible_region{
+        .x_begin = static_cast<std::uint16_t>(visible_x_begin / step * step),
+        .y_begin = static_cast<std::uint16_t>(visible_y_begin / step * step),
+        .x_end = visible_x_end,
+        .y_end = visible_y_end,
+        .step = step
+    };
+    if (
+        !requested_region.contains(visible_region) ||
+        requested_region.get_cols() * requested_region.get_rows() >
+        9 * visible_region.get_cols() * visible_region.get_rows()
+    ) {
+        const std::uint16_t
+            margin_x = (visible_x_end - visible_x_begin) / 2 / step * step,
+            margin_y = (visible_y_end - visible_y_begin) / 2 / step * step;
+        requested_region = {
+            .x_begin = static_cast<std::uint16_t>(
+                std::max(visible_region.x_begin - margin_x, 0)
+            ),
+            .y_begin = static_cast<std::uint16_t>(
+                std::max(visible_region.y_begin - margin_y, 0)
+            ),
+            .x_end = static_cast<std::uint16_t>(
+                std::min<std::int32_t>(visible_x_end + margin_x, world.w)
+            ),
+            .y_end = static_cast<std::uint16_t>(
+                std::min<std::int32_t>(visible_y_end + margin_y, world.h)
+            ),
+            .step = step
+        };
+        sim.push({ .type = Command::Type::SetRegion, .region = requested_region });
+    }
+    const SDL_Rect world_rect{
+        .x = cam_x,
+        .y = y_bound + cam_y,
+        .w = world.w * tile_w / zoom_div,
+        .h = world.h * tile_h / zoom_div
+    };
+    if (overview_level > 0) {
+        const std::uint16_t
+            x_begin = visible_region.x_begin,
+            y_begin = visible_region.y_begin;
+        const std::int32_t
+            x_end = x_begin + (visible_x_end - x_begin + step - 1) / step * step,
+            y_end = y_begin + (visible_y_end - y_begin + step - 1) / step * step;
+        dstrect.x = x_begin * tile_w / zoom_div + cam_x;
+        dstrect.y = y_begin * tile_h / zoom_div + y_bound + cam_y;
+        dstrect.w = x_end * tile_w / zoom_div + cam_x - dstrect.x;
+        dstrect.h = y_end * tile_h / zoom_div + y_bound + cam_y - dstrect.y;
+        // Every texel spans a whole step, so the last ones are cut back to the world's edges
+        if (
+            SDL_RenderSetClipRect(ctx.renderer, &world_rect) != 0 ||
+            !render_overview(
+                view, x_begin, y_begin, visible_x_end, visible_y_end, step, dstrect
+            ) ||
+            SDL_RenderSetClipRect(ctx.renderer, nullptr) != 0
+        ) {
+            return false;
+        }
+        dstrect.w = tile_w;
+        dstrect.h = tile_h;
+    } else {
+        if (
+            !render_background(
+                view,
+                cam_x,
+                cam_y,
+                tile_w,
+                tile_h,
+                y_bound,
+                visible_x_begin,
+                visible_y_begin,
+                visible_x_end,
+                visible_y_end
+            )
+        ) {
+            return false;
+        }
+        batch_tiles(
+            view,
+            visible_x_begin,
+            visible_y_begin,
+            visible_x_end,
+            visible_y_end,
+            cam_x,
+            y_bound + cam_y,
+            tile_w,
+            tile_h,
+            animation_tick == 0 ?
+                std::nullopt : std::optional<std::uint32_t>(curr_tick - animation_tick),
+            speed
+        );
+    }
+    if (!ctx.flush()) {
+        return false;
+    }
+    if (
+        is_mouse_within_bounds &&
+        disp_x >= 0 &&
+        disp_y >= 0 &&
+        disp_x < world_px_w &&
+        disp_y < world_px_h
+    ) {
+        dstrect.x =
+            disp_x * zoom_div / tile_w * tile_w / zoom_div + cam_x +
+            (tile_w / zoom_div - tile_w) / 2;
+        dstrect.y =
+            disp_y * zoom_div / tile_h * tile_h / zoom_div + y_bound + cam_y +
+            (tile_h / zoom_div - tile_h) / 2;
+        if (
+            dstrect.x + dstrect.w >= 0 &&
+            dstrect.y + dstrect.h >= y_bound &&
+            dstrect.x < ctx.window_w &&
+            dstrect.y < ctx.window_h
+        ) {
+            select_still_frame(
+                srcrect,
+                Still::Cursor
+            );
+            if (!ctx.render(srcrect, dstrect)) {
+                return false;
+            }
+        }
+    }
+    if (view.map_w != 0 && !update_heatmap(view, heatmap)) {
+        return false;
+    }
+    if (view.map_w != 0 && heatmap != Heatmap::Off) {
+        const SDL_Rect heatmap_rect{
+            .x = cam_x,
+            .y = y_bound + cam_y,
+            .w = view.map_w * view.map_span * tile_w / zoom_div,
+            .h = view.map_h * view.map_span * tile_h / zoom_div
+        };
+        // The map's last tiles span past the world's edges, so they are cut back like the overview
+        if (
+            SDL_SetTextureAlphaMod(ctx.heatmap_texture, HEATMAP_OVERLAY_ALPHA) != 0 ||
+            SDL_RenderSetClipRect(ctx.renderer, &world_rect) != 0 ||
+            SDL_RenderCopy(ctx.renderer, ctx.heatmap_texture, nullptr, &heatmap_rect) != 0 ||
+            SDL_RenderSetClipRect(ctx.renderer, nullptr) != 0
+        ) {
+            return false;
+        }
+    }
+    if (view.has_ptr) {
+        dstrect.x =
+            view.ptr_x * tile_w / zoom_div + cam_x +
+            (tile_w / zoom_div - tile_w) / 2;
+        dstrect.y =
+            view.ptr_y * tile_h / zoom_div + y_bound + cam_y +
+            (tile_h / zoom_div - tile_h) / 2;
+        if (
+            dstrect.x + dstrect.w >= 0 &&
+            dstrect.y + dstrect.h >= y_bound &&
+            dstrect.x < ctx.window_w &&
+            dstrect.y < ctx.window_h
+        ) {
+            select_still_frame(
+                srcrect,
+                Still::Pointer
+            );
+            if (!ctx.render(srcrect, dstrect)) {
+                return false;
+            }
+        }
+    }
+    if (view.map_w == 0) {
+        return true;
+    }
+    const SDL_Rect viewport_rect{
+        .x = minimap_rect.x + static_cast<std::int32_t>(visible_x_begin * minimap_scale),
+        .y = minimap_rect.y + static_cast<std::int32_t>(visible_y_begin * minimap_scale),
+        .w = std::max<std::int32_t>((visible_x_end - visible_x_begin) * minimap_scale, 1),
+        .h = std::max<std::int32_t>((visible_y_end - visible_y_begin) * minimap_scale, 1)
+    };
+    const SDL_Rect map_rect{
+        .x = minimap_rect.x,
+        .y = minimap_rect.y,
+        .w = static_cast<std::int32_t>(view.map_w * view.map_span * minimap_scale),
+        .h = static_cast<std::int32_t>(view.map_h * view.map_span * minimap_scale)
+    };
+    return
+        SDL_SetTextureAlphaMod(ctx.heatmap_texture, 0xFF) == 0 &&
+        SDL_RenderSetClipRect(ctx.renderer, &minimap_rect) == 0 &&
+        SDL_RenderCopy(ctx.renderer, ctx.heatmap_texture, nullptr, &map_rect) == 0 &&
+        SDL_RenderSetClipRect(ctx.renderer, nullptr) == 0 &&
+        SDL_SetRenderDrawColor(
+            ctx.renderer,
+            COLOR_FG.r,
+            COLOR_FG.g,
+            COLOR_FG.b,
+            COLOR_FG.a
+        ) == 0 &&
+        SDL_RenderDrawRect(ctx.renderer, &viewport_rect) == 0;
+}
+
+bool is_running = true;
+
+bool tick() {
+    SDL_GetWindowSize(ctx.window, &ctx.window_w, &ctx.window_h);
+    ctx.scroll_x = 0;
+    ctx.scroll_y = 0;
+    SDL_Event ev;
+    nk_input_begin(ctx.nk_ctx);
+    while (SDL_PollEvent(&ev)) {
+        switch (ev.type) {
+        case SDL_QUIT:
+            nk_input_end(ctx.nk_ctx);
+            is_running = false;
+            return true;
+        case SDL_MOUSEWHEEL:
+            ctx.scroll_x = ev.wheel.x;
+            ctx.scroll_y = ev.wheel.y;
+            break;
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            background_cache.is_valid = false;
+        }
+        nk_sdl_handle_event(&ev);
+    }
+    nk_input_end(ctx.nk_ctx);
+    gui::render();
+    if (
+        SDL_SetRenderDrawColor(
+            ctx.renderer,
+            COLOR_BG.r,
+            COLOR_BG.g,
+            COLOR_BG.b,
+            COLOR_BG.a
+        ) != 0 ||
+        SDL_RenderClear(ctx.renderer) != 0
+    ) {
+        return false;
+    }
+    switch (active_ux_state) {
+    case UXState::Creation:
+        if (!ux_creation()) {
+            return false;
+        }
+        break;
+    case UXState::Generation:
+        if (!ux_generation()) {
+            return false;
+        }
+        break;
+    case UXState::Sim:
+        if (!begin_recording_frame() || !ux_sim() || !recorder.end_capture()) {
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    nk_sdl_render(NK_ANTI_ALIASING_ON);
+    SDL_RenderPresent(ctx.renderer);
+    return true;
+}
+
+// Welford's online mean and variance, mergeable across threads with Chan's formula
+struct RunningStats {
+    std::uint32_t count;
+    double mean, m2;
+    void push(double value) noexcept {
+        ++count;
+        const double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+    void merge(const RunningStats &other) noexcept {
+        if (other.count == 0) {
+            return;
+        }
+        const std::uint32_t total = count + other.count;
+        const double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+    }
+    double get_variance() const noexcept {
+        return count > 1 ? m2 / (count - 1) : 0;
+    }
+};
+
+struct EnsembleStats {
+    RunningStats population;
+    std::array<RunningStats, Evolution::COUNT> prevalences;
+    void push(const PopulationStats &stats) noexcept {
+        population.push(stats.live_cell_count);
+        for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+            prevalences[i].push(
+                stats.live_cell_count ?
+                    static_cast<double>(stats.evolved_cell_counts[i]) / stats.live_cell_count :
+                    0
+            );
+        }
+    }
+    void merge(const EnsembleStats &other) noexcept {
+        population.merge(other.population);
+        for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+            prevalences[i].merge(other.prevalences[i]);
+        }
+    }
+};
+
+// Runs independent worlds, seeded consecutively from the base seed. Threads pull runs off a
+// shared counter so uneven runs (e.g. early extinctions) don't leave cores idle, and each keeps
+// its own per-generation stats, merged once at the end
+std::optional<std::vector<EnsembleStats>> simulate_ensemble(
+    std::uint32_t runs,
+    std::uint32_t seed,
+    std::uint32_t thread_count
+) {
+    std::atomic<std::uint32_t> next_run = 0;
+    std::atomic<bool> is_out_of_memory = false;
+    std::vector<std::vector<EnsembleStats>> worker_stats(
+        thread_count, std::vector<EnsembleStats>(options.ensemble_gens + 1)
+    );
+    {
+        std::vector<std::jthread> workers;
+        for (std::uint32_t i = 0; i < thread_count; ++i) {
+            workers.emplace_back([&, &stats = worker_stats[i]]() {
+                World run_world{};
+                LineageLog run_lineage_log;
+                std::atomic<std::uint32_t> tiles_generated = 0;
+                for (
+                    std::uint32_t run = next_run.fetch_add(1, std::memory_order_relaxed);
+                    run < runs;
+                    run = next_run.fetch_add(1, std::memory_order_relaxed)
+                ) {
+                    if (
+                        !run_world.create(
+                            options.world_w, options.world_h, options.huge_pages, ""
+                        )
+                    ) {
+                        is_out_of_memory.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                    run_world.rng.srand(seed + run);
+                    if (!options.lineage_file.empty()) {
+                        const std::string path =
+                            std::format("{}.{}", options.lineage_file, seed + run);
+                        if (run_lineage_log.open(path, false)) {
+                            run_world.lineage = &run_lineage_log;
+                        } else {
+                            std::println(std::cerr, "[Lineage warning] Couldn't open {}", path);
+                        }
+                    }
+                    generate(run_world, {}, tiles_generated);
+                    stats[0].push(count_population(run_world));
+                    for (std::uint32_t gen = 1; gen <= options.ensemble_gens; ++gen) {
+                        advance(run_world);
+                        stats[gen].push(count_population(run_world));
+                    }
+                    run_world.destroy();
+                }
+            });
+        }
+    }
+    if (is_out_of_memory.load(std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+    for (std::uint32_t i = 1; i < thread_count; ++i) {
+        for (std::uint32_t gen = 0; gen <= options.ensemble_gens; ++gen) {
+            worker_stats[0][gen].merge(worker_stats[i][gen]);
+        }
+    }
+    return std::move(worker_stats[0]);
+}
+
+// Writes every interval-th generation, plus the last one, as CSV
+void write_stats(std::ostream &stream, const std::vector<EnsembleStats> &stats) {
+    const std::uint32_t interval = options.stats_interval.value_or(1);
+    std::print(stream, "gen,population_mean,population_variance");
+    for (const Evolution &evolution : rules.evolutions) {
+        std::print(
+            stream, ",{0}_prevalence_mean,{0}_prevalence_variance", get_key(evolution.name)
+        );
+    }
+    std::println(stream, "");
+    for (std::uint32_t gen = 0; gen < stats.size(); ++gen) {
+        if (gen % interval != 0 && gen + 1 != stats.size()) {
+            continue;
+        }
+        const EnsembleStats &gen_stats = stats[gen];
+        std::print(
+            stream, "{},{},{}", gen, gen_stats.population.mean, gen_stats.population.get_variance()
+        );
+        for (const RunningStats &prevalence : gen_stats.prevalences) {
+            std::print(stream, ",{},{}", prevalence.mean, prevalence.get_variance());
+        }
+        std::println(stream, "");
+    }
+}
+
+bool run_ensemble() {
+    const std::uint32_t
+        seed = options.seed.value_or(static_cast<std::uint32_t>(std::time(nullptr))),
+        thread_count = std::min(get_thread_count(), options.ensemble_runs);
+    std::println(
+        "Running {} worlds of {}x{} for {} generations on {} threads, seeds {}..{}",
+        options.ensemble_runs,
+        options.world_w,
+        options.world_h,
+        options.ensemble_gens,
+        thread_count,
+        seed,
+        seed + options.ensemble_runs - 1
+    );
+    const auto start_time = std::chrono::steady_clock::now();
+    const std::optional<std::vector<EnsembleStats>> stats =
+        simulate_ensemble(options.ensemble_runs, seed, thread_count);
+    if (!stats) {
+        std::println(std::cerr, "[Ensemble error] Out of memory, try fewer threads or smaller worlds");
+        return false;
+    }
+    std::ofstream file(options.stats_file);
+    if (!file) {
+        std::println(std::cerr, "[Ensemble error] Couldn't open {}", options.stats_file);
+        return false;
+    }
+    write_stats(file, *stats);
+    std::println(
+        "Done in {:.3f} s, stats written to {}",
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count(),
+        options.stats_file
+    );
+    return true;
+}
+
+struct Frame {
+    std::uint32_t gen;
+    std::vector<std::uint32_t> pixels;
+};
+
+constexpr std::uint32_t FRAME_QUEUE_CAPACITY = 64;
+
+constexpr std::int32_t MAX_FRAME_SIZE = 16384;
+
+// Frames cycle between a free queue and an encode queue, so only a bounded number of them are
+// ever in flight while a pool of threads compresses them to PNG files off the simulation thread
+class FrameEncoder {
+    std::filesystem::path dir;
+    std::int32_t w, h;
+    std::vector<Frame> frames;
+    BoundedQueue<Frame *, FRAME_QUEUE_CAPACITY> free_frames, pending_frames;
+    std::counting_semaphore<> free_count, pending_count;
+    std::vector<std::jthread> threads;
+    std::atomic<bool> has_failed;
+    void encode() {
+        for (;;) {
+            pending_count.acquire();
+            // The count guarantees a frame, but another thread may not have published its slot
+            Frame *frame;
+            while (!pending_frames.pop(frame)) {
+                std::this_thread::yield();
+            }
+            // One null frame per thread marks the end
+            if (!frame) {
+                return;
+            }
+            const std::filesystem::path path = dir / std::format("frame_{:08}.png", frame->gen);
+            SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(
+                frame->pixels.data(),
+                w,
+                h,
+                32,
+                w * sizeof(std::uint32_t),
+                SDL_PIXELFORMAT_ARGB8888
+            );
+            if (!surface || IMG_SavePNG(surface, path.string().c_str()) != 0) {
+                std::println(std::cerr, "[Frames error] Couldn't write {}", path.string());
+                has_failed.store(true, std::memory_order_relaxed);
+            }
+            SDL_FreeSurface(surface);
+            free_frames.push(frame);
+            free_count.release();
+        }
+    }
+public:
+    FrameEncoder(const std::filesystem::path &dir, std::int32_t w, std::int32_t h) :
+        dir{ dir },
+        w{ w },
+        h{ h },
+        frames{},
+        free_frames{},
+        pending_frames{},
+        free_count{ 0 },
+        pending_count{ 0 },
+        threads{},
+        has_failed{ false }
+    {}
+    ~FrameEncoder() {
+        finish();
+    }
+    void start(std::uint32_t thread_count) {
+        frames.resize(std::min(2 * thread_count, FRAME_QUEUE_CAPACITY));
+        for (Frame &frame : frames) {
+            frame.pixels.resize(static_cast<std::size_t>(w) * h);
+            free_frames.push(&frame);
+            free_count.release();
+        }
+        for (std::uint32_t i = 0; i < thread_count; ++i) {
+            threads.emplace_back([this]() {
+                encode();
+            });
+        }
+    }
+    // Blocks only while every frame is still waiting to be encoded
+    Frame &acquire() {
+        free_count.acquire();
+        Frame *frame;
+        while (!free_frames.pop(frame)) {
+            std::this_thread::yield();
+        }
+        return *frame;
+    }
+    void submit(Frame &frame) {
+        pending_frames.push(&frame);
+        pending_count.release();
+    }
+    // Encodes the remaining frames and stops the threads
+    bool finish() {
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            // The queue may be full of frames until the threads make room for the end markers
+            while (!pending_frames.push(nullptr)) {
+                std::this_thread::yield();
+            }
+            pending_count.release();
+        }
+        threads.clear();
+        return !has_failed.load(std::memory_order_relaxed);
+    }
+};
+
+// Draws the whole world offscreen with the same sprites as the window, half-way through the
+// animation of the step that led to it so the frame shows the events of its generation
+bool render_frame(const WorldView &view, std::int32_t tile_size, Frame &frame) {
+    if (
+        SDL_SetRenderDrawColor(
+            ctx.renderer,
+            COLOR_BG.r,
+            COLOR_BG.g,
+            COLOR_BG.b,
+            COLOR_BG.a
+        ) != 0 ||
+        SDL_RenderClear(ctx.renderer) != 0
+    ) {
+        return false;
+    }
+    SDL_Rect
+        srcrect{ .w = TILE_WIDTH, .h = TILE_HEIGHT },
+        dstrect{ .w = tile_size,  .h = tile_size   };
+    select_still_frame(
+        srcrect,
+        Still::Tile
+    );
+    const TileView *tile_view = view.tiles.data();
+    for (std::uint16_t x = 0; x < world.w; ++x) {
+        dstrect.x = x * tile_size;
+        for (std::uint16_t y = 0; y < world.h; ++y, ++tile_view) {
+            dstrect.y = y * tile_size;
+            batch_background_tile(srcrect, dstrect, tile_view->tint);
+        }
+    }
+    if (!ctx.flush()) {
+        return false;
+    }
+    batch_tiles(
+        view,
+        0,
+        0,
+        world.w,
+        world.h,
+        0,
+        0,
+        tile_size,
+        tile_size,
+        view.gen == 0 ? std::nullopt : std::optional<std::uint32_t>(ANIMATION_MS / 2),
+        1
+    );
+    frame.gen = view.gen;
+    return
+        ctx.flush() &&
+        SDL_RenderReadPixels(
+            ctx.renderer,
+            nullptr,
+            SDL_PIXELFORMAT_ARGB8888,
+            frame.pixels.data(),
+            ctx.window_w * sizeof(std::uint32_t)
+        ) == 0;
+}
+
+// Runs one world headless and exports every frame_interval-th generation as a PNG. The
+// simulation thread only captures and rasterizes, encoding happens on the other cores. Synchronous
+// updates run on threads of their own, so they share the thread count with the encoders.
+bool run_frame_export() {
+    const bool is_synchronous = options.update_mode == UpdateMode::Synchronous;
+    const std::uint32_t
+        seed = options.seed.value_or(static_cast<std::uint32_t>(std::time(nullptr))),
+        thread_count = get_thread_count(),
+        encoder_count = !is_synchronous ?
+            (options.encoder_threads ? options.encoder_threads : thread_count) :
+            std::clamp(
+                options.encoder_threads ? options.encoder_threads : thread_count / 2,
+                1u,
+                std::max(thread_count - 1, 1u)
+            );
+    const std::int64_t
+        w = static_cast<std::int64_t>(options.world_w) * options.frame_tile,
+        h = static_cast<std::int64_t>(options.world_h) * options.frame_tile;
+    if (w > MAX_FRAME_SIZE || h > MAX_FRAME_SIZE) {
+        std::println(
+            std::cerr,
+            "[Frames error] Frames would be {}x{}, try a smaller --frame-tile or world",
+            w,
+            h
+        );
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(options.frames_dir, error);
+    if (error) {
+        std::println(std::cerr, "[Frames error] Couldn't create {}", options.frames_dir);
+        return false;
+    }
+    if (!ctx.init_offscreen(w, h)) {
+        std::println(std::cerr, "[SDL error] {}", SDL_GetError());
+        return false;
+    }
+    world.rng.srand(seed);
+    if (!world.create(options.world_w, options.world_h, options.huge_pages, "")) {
+        std::println(std::cerr, "[Frames error] Out of memory, try a smaller world");
+        return false;
+    }
+    if (!options.lineage_file.empty()) {
+        if (!lineage_log.open(options.lineage_file, false)) {
+            std::println(std::cerr, "[Lineage error] Couldn't open {}", options.lineage_file);
+            world.destroy();
+            return false;
+        }
+        world.lineage = &lineage_log;
+    }
+    if (!options.stream_name.empty()) {
+        if (!state_stream.open(options.stream_name, world.w, world.h)) {
+            std::println(std::cerr, "[Stream error] Couldn't create {}", options.stream_name);
+            world.destroy();
+            return false;
+        }
+        world.stream = &state_stream;
+    }
+    world.scheduler = &advance_scheduler;
+    if (is_synchronous) {
+        advance_scheduler.request_threads(std::max(thread_count - encoder_count, 1u));
+    }
+    std::atomic<std::uint32_t> tiles_generated{ 0 };
+    generate(world, std::stop_token{}, tiles_generated);
+    std::println(
+        "Exporting a world of {}x{} (seed {}) for {} generations as {}x{} frames every {} "
+        "generations on {} encoder threads",
+        options.world_w,
+        options.world_h,
+        seed,
+        options.ensemble_gens,
+        w,
+        h,
+        options.frame_interval,
+        encoder_count
+    );
+    const auto start_time = std::chrono::steady_clock::now();
+    FrameEncoder encoder(options.frames_dir, w, h);
+    encoder.start(encoder_count);
+    const ViewRegion region{ .x_end = world.w, .y_end = world.h, .step = 1 };
+    WorldView view{};
+    std::uint32_t frame_count = 0;
+    for (;;) {
+        if (world.gen % options.frame_interval == 0) {
+            view.capture(count_live_cells(world), region);
+            Frame &frame = encoder.acquire();
+            if (!render_frame(view, options.frame_tile, frame)) {
+                std::println(std::cerr, "[SDL error] {}", SDL_GetError());
+                encoder.finish();
+                world.destroy();
+                return false;
+            }
+            encoder.submit(frame);
+            ++frame_count;
+        }
+        if (world.gen >= options.ensemble_gens) {
+            break;
+        }
+        advance(world);
+    }
+    const bool is_written = encoder.finish();
+    world.destroy();
+    std::println(
+        "Done in {:.3f} s, {} frames written to {}",
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count(),
+        frame_count,
+        options.frames_dir
+    );
+    print_node_throughput();
+    return is_written;
+}
+
+struct CellHistory {
+    std::uint64_t parent_id;
+    std::uint32_t birth_gen, death_gen;
+    std::uint8_t evolutions;
+    bool is_known;
+};
+
+constexpr std::uint32_t LINEAGE_ALIVE = std::numeric_limits<std::uint32_t>::max();
+
+constexpr std::uint32_t LINEAGE_TOP_FOUNDERS = 10;
+
+std::string get_evolution_names(std::uint8_t evolutions) {
+    std::string names;
+    for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+        if (evolutions >> i & 1) {
+            names += std::format("{}{}", names.empty() ? "" : ", ", rules.evolutions[i].name);
+        }
+    }
+    return names.empty() ? "none" : names;
+}
+
+std::string describe_cell(std::uint64_t id, const CellHistory &cell) {
+    return std::format(
+        "#{} born at gen {}, {}, evolutions: {}",
+        id,
+        cell.birth_gen,
+        cell.death_gen == LINEAGE_ALIVE ?
+            std::string("alive") : std::format("died at gen {}", cell.death_gen),
+        get_evolution_names(cell.evolutions)
+    );
+}
+
+// Replays a lineage log into one history per cell. Cell IDs are handed out consecutively, and
+// always after their parent's, so histories are indexed by ID and ancestry resolves in one pass
+bool run_lineage_query() {
+    std::ifstream file(options.lineage_query_file, std::ios::binary);
+    LineageFileHeader header;
+    if (
+        !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != LineageFileHeader::MAGIC ||
+        header.version != LineageFileHeader::VERSION ||
+        header.record_size != sizeof(LineageRecord)
+    ) {
+        std::println(
+            std::cerr, "[Lineage error] {} isn't a compatible lineage log", options.lineage_query_file
+        );
+        return false;
+    }
+    std::vector<CellHistory> cells(1);
+    std::uint32_t last_gen = 0;
+    LineageRecord record;
+    while (file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        if (record.cell_id >= cells.size()) {
+            cells.resize(record.cell_id + 1);
+        }
+        CellHistory &cell = cells[record.cell_id];
+        switch (record.event) {
+        case LineageEvent::Birth:
+            cell = {
+                .parent_id = record.parent_id,
+                .birth_gen = record.gen,
+                .death_gen = LINEAGE_ALIVE,
+                .evolutions = record.evolutions,
+                .is_known = true
+            };
+            break;
+        case LineageEvent::Death:
+            cell.death_gen = record.gen;
+            break;
+        case LineageEvent::Evolutions:
+            cell.evolutions = record.evolutions;
+            break;
+        }
+        last_gen = std::max(last_gen, record.gen);
+    }
+    const auto is_valid_id = [&](std::uint64_t id) {
+        if (id < cells.size() && cells[id].is_known) {
+            return true;
+        }
+        std::println(std::cerr, "[Lineage error] No cell #{} in the log", id);
+        return false;
+    };
+    if (options.ancestors_of) {
+        if (!is_valid_id(*options.ancestors_of)) {
+            return false;
+        }
+        for (std::uint64_t id = *options.ancestors_of; id != 0; id = cells[id].parent_id) {
+            std::println("{}", describe_cell(id, cells[id]));
+        }
+        return true;
+    }
+    std::vector<std::uint64_t> child_offsets(cells.size() + 1), children(cells.size());
+    for (std::uint64_t id = 1; id < cells.size(); ++id) {
+        child_offsets[cells[id].parent_id + 1] += cells[id].is_known;
+    }
+    for (std::uint64_t id = 1; id < child_offsets.size(); ++id) {
+        child_offsets[id] += child_offsets[id - 1];
+    }
+    std::vector<std::uint64_t> child_counts(cells.size());
+    for (std::uint64_t id = 1; id < cells.size(); ++id) {
+        if (cells[id].is_known) {
+            const std::uint64_t parent_id = cells[id].parent_id;
+            children[child_offsets[parent_id] + child_counts[parent_id]++] = id;
+        }
+    }
+    if (options.descendants_of) {
+        if (!is_valid_id(*options.descendants_of)) {
+            return false;
+        }
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> stack{ { *options.descendants_of, 0 } };
+        while (!stack.empty()) {
+            const auto [id, depth] = stack.back();
+            stack.pop_back();
+            std::println("{:{}}{}", "", depth * 2, describe_cell(id, cells[id]));
+            for (std::uint64_t i = child_offsets[id + 1]; i-- > child_offsets[id];) {
+                stack.emplace_back(children[i], depth + 1);
+            }
+        }
+        return true;
+    }
+    std::vector<std::uint64_t> founder_ids(cells.size()), alive_counts(cells.size());
+    std::uint64_t alive_count = 0;
+    for (std::uint64_t id = 1; id < cells.size(); ++id) {
+        founder_ids[id] = cells[id].parent_id ? founder_ids[cells[id].parent_id] : id;
+        if (cells[id].is_known && cells[id].death_gen == LINEAGE_ALIVE) {
+            ++alive_counts[founder_ids[id]];
+            ++alive_count;
+        }
+    }
+    std::vector<std::uint64_t> founders;
+    for (std::uint64_t id = child_offsets[0]; id < child_offsets[1]; ++id) {
+        founders.push_back(children[id]);
+    }
+    const std::size_t top_count = std::min<std::size_t>(LINEAGE_TOP_FOUNDERS, founders.size());
+    std::partial_sort(
+        founders.begin(),
+        founders.begin() + top_count,
+        founders.end(),
+        [&](std::uint64_t a, std::uint64_t b) { return alive_counts[a] > alive_counts[b]; }
+    );
+    std::println(
+        "{} cells from {} founders up to gen {}, {} alive",
+        cells.size() - 1,
+        founders.size(),
+        last_gen,
+        alive_count
+    );
+    std::println("Founders with the most living descendants:");
+    for (std::size_t i = 0; i < top_count; ++i) {
+        std::println("  #{}: {} alive", founders[i], alive_counts[founders[i]]);
+    }
+    return true;
+}
+
+#ifndef _WIN32
+
+// A sweep directory holds:
+// - spec.txt and settings.txt: the sweep spec and the worker options, kept to resume it
+// - points.csv: the parameter values of every point
+// - queue/<point>: a rules file per point left to run
+// - claimed/<point>.<pid>: points being run, claimed by a worker by atomically renaming them
+// - results/<point>.csv: the stats of every finished point, renamed into place when complete
+// So a point is lost at worst when its worker dies, in which case its claim is put back in the
+// queue, either right away by the coordinator or by the next resume
+constexpr const char
+    *SWEEP_QUEUE_DIR   = "queue",
+    *SWEEP_CLAIMED_DIR = "claimed",
+    *SWEEP_RESULTS_DIR = "results";
+
+constexpr std::uint32_t SWEEP_MAX_WORKER_DEATHS_PER_WORKER = 3;
+
+constexpr std::chrono::milliseconds SWEEP_POLL_INTERVAL{ 500 };
+
+struct SweepAxis {
+    std::string key;
+    std::vector<std::uint32_t> values;
+};
+
+std::string read_file(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Writes next to the path and renames into place, so readers never see a partial file
+bool write_file(const std::filesystem::path &path, std::string_view contents) {
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path);
+        if (!(file << contents)) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+// Reads "key = values" lines, with "#" comments, where values are comma separated numbers or
+// inclusive "first..last" and "first..last:step" ranges. Every combination is a point
+bool load_sweep_spec(const std::string &path, std::vector<SweepAxis> &axes) {
+    std::ifstream file(path);
+    if (!file) {
+        std::println(std::cerr, "[Sweep error] Couldn't open {}", path);
+        return false;
+    }
+    Rules test_rules = rules;
+    std::string line;
+    for (std::uint32_t line_number = 1; std::getline(file, line); ++line_number) {
+        const std::string_view content = trim(std::string_view(line).substr(0, line.find('#')));
+        if (content.empty()) {
+            continue;
+        }
+        const std::size_t separator = content.find('=');
+        SweepAxis axis{ .key = std::string(trim(content.substr(0, separator))), .values = {} };
+        std::string_view values =
+            separator == std::string_view::npos ? "" : content.substr(separator + 1);
+        bool is_valid = !values.empty();
+        while (is_valid && !values.empty()) {
+            const std::size_t comma = values.find(',');
+            const std::string_view item = trim(values.substr(0, comma));
+            values = comma == std::string_view::npos ? "" : values.substr(comma + 1);
+            const std::size_t range = item.find("..");
+            std::uint32_t first, last = 0, step = 1;
+            if (range == std::string_view::npos) {
+                is_valid = parse_number(item, first);
+                last = first;
+            } else {
+                const std::string_view bounds = item.substr(range + 2);
+                const std::size_t colon = bounds.find(':');
+                is_valid =
+                    parse_number(item.substr(0, range), first) &&
+                    parse_number(bounds.substr(0, colon), last) &&
+                    (colon == std::string_view::npos || parse_number(bounds.substr(colon + 1), step)) &&
+                    first <= last &&
+                    step != 0;
+            }
+            for (std::uint64_t value = first; is_valid && value <= last; value += step) {
+                axis.values.push_back(value);
+            }
+        }
+        if (!is_valid) {
+            std::println(
+                std::cerr, "[Sweep error] {}:{}: expected key = values or ranges", path, line_number
+            );
+            return false;
+        }
+        for (std::uint32_t value : axis.values) {
+            if (!set_rule(test_rules, axis.key, value) || !is_valid_rules(test_rules)) {
+                std::println(
+                    std::cerr,
+                    "[Sweep error] {}:{}: invalid rule {} = {}",
+                    path,
+                    line_number,
+                    axis.key,
+                    value
+                );
+                return false;
+            }
+        }
+        axes.push_back(std::move(axis));
+    }
+    return true;
+}
+
+std::string get_sweep_point_name(std::uint64_t point) {
+    return std::format("{:08}", point);
+}
+
+// Points enumerate the grid with the last axis varying fastest
+std::string get_sweep_point_rules(const std::vector<SweepAxis> &axes, std::uint64_t point) {
+    std::string point_rules;
+    for (auto axis = axes.rbegin(); axis != axes.rend(); ++axis) {
+        point_rules.insert(
+            0, std::format("{} = {}\n", axis->key, axis->values[point % axis->values.size()])
+        );
+        point /= axis->values.size();
+    }
+    return point_rules;
+}
+
+// Puts back every claim whose file name ends with the suffix
+void requeue_sweep_claims(const std::filesystem::path &dir, std::string_view suffix) {
+    std::error_code error;
+    for (
+        const std::filesystem::directory_entry &entry :
+        std::filesystem::directory_iterator(dir / SWEEP_CLAIMED_DIR, error)
+    ) {
+        const std::string name = entry.path().filename().string();
+        if (name.ends_with(suffix)) {
+            std::filesystem::rename(
+                entry.path(), dir / SWEEP_QUEUE_DIR / entry.path().stem(), error
+            );
+        }
+    }
+}
+
+std::uint64_t count_files(const std::filesystem::path &dir) {
+    std::error_code error;
+    std::uint64_t count = 0;
+    for (
+        const std::filesystem::directory_entry &entry :
+        std::filesystem::directory_iterator(dir, error)
+    ) {
+        count += entry.path().extension() != ".tmp";
+    }
+    return count;
+}
+
+pid_t spawn_worker(
+    const std::vector<std::string> &worker_args,
+    const posix_spawn_file_actions_t *file_actions = nullptr
+) {
+    std::vector<char *> argv;
+    argv.push_back(options.executable.data());
+    for (const std::string &arg : worker_args) {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    pid_t pid;
+    if (
+        posix_spawnp(
+            &pid, options.executable.c_str(), file_actions, nullptr, argv.data(), environ
+        ) != 0
+    ) {
+        return -1;
+    }
+    return pid;
+}
+
+// The coordinator only shards and supervises: it fills the queue with the points that have no
+// result yet, then keeps a pool of headless worker processes running until the queue drains
+bool run_sweep() {
+    const std::filesystem::path dir = options.sweep_dir;
+    std::vector<SweepAxis> axes;
+    if (!load_sweep_spec(options.sweep_file, axes)) {
+        return false;
+    }
+    std::uint64_t point_count = 1;
+    for (const SweepAxis &axis : axes) {
+        point_count *= axis.values.size();
+        if (point_count > std::numeric_limits<std::uint32_t>::max()) {
+            std::println(std::cerr, "[Sweep error] {} has too many points", options.sweep_file);
+            return false;
+        }
+    }
+    std::error_code error;
+    for (const char *subdir : { SWEEP_QUEUE_DIR, SWEEP_CLAIMED_DIR, SWEEP_RESULTS_DIR }) {
+        std::filesystem::create_directories(dir / subdir, error);
+        if (error) {
+            std::println(std::cerr, "[Sweep error] Couldn't create {}", (dir / subdir).string());
+            return false;
+        }
+    }
+    const std::string spec = read_file(options.sweep_file);
+    std::vector<std::string> worker_args;
+    if (std::filesystem::exists(dir / "spec.txt")) {
+        if (read_file(dir / "spec.txt") != spec) {
+            std::println(
+                std::cerr, "[Sweep error] {} holds a different sweep", dir.string()
+            );
+            return false;
+        }
+        std::istringstream settings(read_file(dir / "settings.txt"));
+        for (std::string arg; std::getline(settings, arg);) {
+            worker_args.push_back(arg);
+        }
+        std::println("Resuming the sweep in {} with its original settings", dir.string());
+    } else {
+        worker_args = {
+            "--sweep-worker", std::filesystem::absolute(dir).string(),
+            "--gens", std::to_string(options.ensemble_gens),
+            "--size", std::format("{}x{}", options.world_w, options.world_h),
+            "--seeds", std::to_string(options.sweep_seeds),
+            "--seed", std::to_string(
+                options.seed.value_or(static_cast<std::uint32_t>(std::time(nullptr)))
+            ),
+            "--stats-interval", std::to_string(
+                options.stats_interval.value_or(options.ensemble_gens ? options.ensemble_gens : 1)
+            ),
+            "--huge-pages", std::string(HUGE_PAGES_NAMES[std::to_underlying(options.huge_pages)]),
+            "--update", std::string(UPDATE_MODE_NAMES[std::to_underlying(options.update_mode)]),
+            "--rng", std::string(RNG_DRAWS_NAMES[std::to_underlying(options.rng_draws)])
+        };
+        if (!options.rules_file.empty()) {
+            worker_args.push_back("--rules");
+            worker_args.push_back(std::filesystem::absolute(options.rules_file).string());
+        }
+        std::string settings, points = "point";
+        for (const std::string &arg : worker_args) {
+            settings += arg + '\n';
+        }
+        for (const SweepAxis &axis : axes) {
+            points += ',' + axis.key;
+        }
+        points += '\n';
+        for (std::uint64_t point = 0; point < point_count; ++point) {
+            points += get_sweep_point_name(point);
+            std::uint64_t remainder = point, stride = point_count;
+            for (const SweepAxis &axis : axes) {
+                stride /= axis.values.size();
+                points += std::format(",{}", axis.values[remainder / stride]);
+                remainder %= stride;
+            }
+            points += '\n';
+        }
+        // The spec goes last, as its presence marks the sweep as resumable
+        if (
+            !write_file(dir / "settings.txt", settings) ||
+            !write_file(dir / "points.csv", points) ||
+            !write_file(dir / "spec.txt", spec)
+        ) {
+            std::println(std::cerr, "[Sweep error] Couldn't write to {}", dir.string());
+            return false;
+        }
+    }
+    // Workers of an interrupted sweep left their claims behind
+    requeue_sweep_claims(dir, "");
+    for (std::uint64_t point = 0; point < point_count; ++point) {
+        const std::string name = get_sweep_point_name(point);
+        if (
+            !std::filesystem::exists(dir / SWEEP_RESULTS_DIR / (name + ".csv")) &&
+            !std::filesystem::exists(dir / SWEEP_QUEUE_DIR / name) &&
+            !write_file(dir / SWEEP_QUEUE_DIR / name, get_sweep_point_rules(axes, point))
+        ) {
+            std::println(std::cerr, "[Sweep error] Couldn't queue point {}", name);
+            return false;
+        }
+    }
+    const std::uint64_t queued_count = count_files(dir / SWEEP_QUEUE_DIR);
+    const std::uint32_t worker_count = std::min<std::uint64_t>(get_thread_count(), queued_count);
+    std::println(
+        "Sweeping {} points, {} left, on {} workers",
+        point_count,
+        queued_count,
+        worker_count
+    );
+    std::uint32_t running_count = 0, death_count = 0;
+    for (std::uint32_t i = 0; i < worker_count; ++i) {
+        if (spawn_worker(worker_args) == -1) {
+            std::println(std::cerr, "[Sweep error] Couldn't start a worker");
+            break;
+        }
+        ++running_count;
+    }
+    std::uint64_t last_done_count = std::numeric_limits<std::uint64_t>::max();
+    while (running_count) {
+        std::int32_t status;
+        const pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid == -1) {
+            break;
+        }
+        if (pid == 0) {
+            const std::uint64_t done_count = count_files(dir / SWEEP_RESULTS_DIR);
+            if (done_count != last_done_count) {
+                std::println("{}/{} points done", done_count, point_count);
+                last_done_count = done_count;
+            }
+            std::this_thread::sleep_for(SWEEP_POLL_INTERVAL);
+            continue;
+        }
+        --running_count;
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            continue;
+        }
+        std::println(std::cerr, "[Sweep warning] Worker {} died, requeueing its point", pid);
+        requeue_sweep_claims(dir, std::format(".{}", pid));
+        if (++death_count > SWEEP_MAX_WORKER_DEATHS_PER_WORKER * worker_count) {
+            std::println(std::cerr, "[Sweep error] Workers keep dying, giving up");
+            continue;
+        }
+        if (count_files(dir / SWEEP_QUEUE_DIR) != 0 && spawn_worker(worker_args) != -1) {
+            ++running_count;
+        }
+    }
+    const std::uint64_t done_count = count_files(dir / SWEEP_RESULTS_DIR);
+    std::println("{}/{} points done, results in {}", done_count, point_count, dir.string());
+    return done_count == point_count;
+}
+
+// Claims points until the queue is empty. Every point runs over the rules given on the command
+// line, with all seeds on this process's single thread, as the coordinator parallelizes by process
+bool run_sweep_worker() {
+    const std::filesystem::path dir = options.sweep_dir;
+    const Rules base_rules = rules;
+    const std::string claim_suffix = std::format(".{}", getpid());
+    for (;;) {
+        std::error_code error;
+        std::filesystem::path claim;
+        for (
+            const std::filesystem::directory_entry &entry :
+            std::filesystem::directory_iterator(dir / SWEEP_QUEUE_DIR, error)
+        ) {
+            if (entry.path().extension() == ".tmp") {
+                continue;
+            }
+            claim = dir / SWEEP_CLAIMED_DIR / entry.path().filename();
+            claim += claim_suffix;
+            std::filesystem::rename(entry.path(), claim, error);
+            if (!error) {
+                break;
+            }
+            claim.clear();
+        }
+        if (claim.empty()) {
+            return true;
+        }
+        rules = base_rules;
+        if (!load_rules(claim.string())) {
+            return false;
+        }
+        select_advance_passes();
+        const std::optional<std::vector<EnsembleStats>> stats =
+            simulate_ensemble(options.sweep_seeds, options.seed.value_or(0), 1);
+        if (!stats) {
+            std::println(std::cerr, "[Sweep error] Out of memory, try fewer workers or smaller worlds");
+            return false;
+        }
+        std::ostringstream result;
+        std::istringstream point_rules(read_file(claim));
+        for (std::string line; std::getline(point_rules, line);) {
+            std::println(result, "# {}", line);
+        }
+        write_stats(result, *stats);
+        const std::filesystem::path name = claim.stem();
+        if (!write_file(dir / SWEEP_RESULTS_DIR / (name.string() + ".csv"), result.str())) {
+            std::println(std::cerr, "[Sweep error] Couldn't write the result of point {}", name.string());
+            return false;
+        }
+        std::filesystem::remove(claim, error);
+    }
+}
+
+constexpr std::size_t CONTROL_MAX_LINE = 4096;
+
+// A client that doesn't take its answer within this time is dropped
+constexpr std::int32_t CONTROL_SEND_TIMEOUT_MS = 1000;
+
+// Serves a line protocol on a Unix domain socket, one command per line answered with "ok", an
+// "error ..." line or, for metrics, the Prometheus text format ending with "# EOF". Commands
+// only go through the sim's queue, so no client can hold up the simulation.
+class ControlServer {
+    struct Client {
+        std::int32_t fd;
+        std::string buffer;
+    };
+    std::string path;
+    std::int32_t listen_fd;
+    // Written to by stop() to wake the server out of poll()
+    std::array<std::int32_t, 2> wake_fds;
+    std::atomic<bool> is_quit_requested;
+    std::jthread thread;
+    // Never blocks for longer than the timeout, so a stalled client can't hold up stop()
+    static bool send_all(std::int32_t fd, std::string_view data) noexcept {
+        while (!data.empty()) {
+            const ssize_t sent = send(
+                fd, data.data(), data.size(), MSG_NOSIGNAL | MSG_DONTWAIT
+            );
+            if (sent > 0) {
+                data.remove_prefix(sent);
+                continue;
+            }
+            if (sent == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                return false;
+            }
+            pollfd poll_fd{ .fd = fd, .events = POLLOUT, .revents = 0 };
+            if (errno != EINTR && poll(&poll_fd, 1, CONTROL_SEND_TIMEOUT_MS) <= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static std::string get_metrics() {
+        const SimMetrics &metrics = sim.get_metrics();
+        std::ostringstream text;
+        const auto print_metric = [&](
+            std::string_view name,
+            std::string_view type,
+            std::string_view help,
+            auto value
+        ) {
+            std::println(text, "# HELP evosim_{} {}", name, help);
+            std::println(text, "# TYPE evosim_{} {}", name, type);
+            std::println(text, "evosim_{} {}", name, value);
+        };
+        print_metric("generations_total", "counter", "Generations advanced.", metrics.gen);
+        print_metric("world_tiles", "gauge", "Tiles in the world.", world.size);
+        print_metric("live_cells", "gauge", "Live cells.", metrics.live_cell_count);
+        print_metric(
+            "tile_energy", "gauge", "Energy held by all tiles.", metrics.summary.tile_energy
+        );
+        print_metric(
+            "max_cell_age", "gauge", "Age of the oldest cell.", metrics.summary.max_cell_age
+        );
+        print_metric(
+            "max_cell_energy",
+            "gauge",
+            "Energy of the richest cell.",
+            metrics.summary.max_cell_energy
+        );
+        std::println(text, "# HELP evosim_evolved_cells Live cells that underwent an evolution.");
+        std::println(text, "# TYPE evosim_evolved_cells gauge");
+        for (std::uint8_t i = 0; i < Evolution::COUNT; ++i) {
+            std::println(
+                text,
+                "evosim_evolved_cells{{evolution=\"{}\"}} {}",
+                rules.evolutions[i].name,
+                metrics.summary.evolved_cell_counts[i]
+            );
+        }
+        print_metric(
+            "running", "gauge", "Whether generations advance on their own.", +metrics.is_auto_mode
+        );
+        print_metric(
+            "fast_forwarding",
+            "gauge",
+            "Whether running at full speed.",
+            +metrics.is_fast_forwarding
+        );
+        print_metric("speed", "gauge", "Speed multiplier, as in the window.", +metrics.speed);
+        print_metric("snapshots_total", "counter", "Snapshots written.", metrics.snapshot_count);
+        print_metric(
+            "snapshot_errors_total",
+            "counter",
+            "Snapshots that couldn't be written.",
+            metrics.snapshot_error_count
+        );
+        const std::vector<NodeStats> node_stats = advance_scheduler.get_node_stats();
+        const auto print_node_metric = [&](
+            std::string_view name,
+            std::string_view type,
+            std::string_view help,
+            auto member
+        ) {
+            std::println(text, "# HELP evosim_{} {}", name, help);
+            std::println(text, "# TYPE evosim_{} {}", name, type);
+            for (const NodeStats &stats : node_stats) {
+                std::println(text, "evosim_{}{{node=\"{}\"}} {}", name, stats.node, stats.*member);
+            }
+        };
+        if (!node_stats.empty()) {
+            print_node_metric(
+                "node_threads", "gauge", "Synchronous update threads.", &NodeStats::thread_count
+            );
+            print_node_metric(
+                "node_tile_updates_total",
+                "counter",
+                "Tiles swept, once per sweep of a generation.",
+                &NodeStats::tile_updates
+            );
+            print_node_metric(
+                "node_busy_seconds_total",
+                "counter",
+                "Time the threads spent sweeping.",
+                &NodeStats::busy_seconds
+            );
+            print_node_metric(
+                "node_remote_tasks_total",
+                "counter",
+                "Tasks taken from another node.",
+                &NodeStats::remote_task_count
+            );
+        }
+        std::println(text, "# EOF");
+        return text.str();
+    }
+    std::string handle(std::string_view line) {
+        const std::size_t separator = line.find(' ');
+        const std::string_view
+            name = line.substr(0, separator),
+            argument = separator == std::string_view::npos ? "" : line.substr(separator + 1);
+        std::uint32_t number = 0;
+        bool is_queued = true;
+        if (name == "start") {
+            is_queued = sim.push({ .type = Command::Type::Start });
+        } else if (name == "stop") {
+            is_queued = sim.push({ .type = Command::Type::Stop });
+        } else if (name == "step") {
+            is_queued = sim.push({ .type = Command::Type::Step });
+        } else if (name == "speed") {
+            if (
+                !parse_number(argument, number) ||
+                number < MIN_SPEED ||
+                number > MAX_SPEED ||
+                !std::has_single_bit(number)
+            ) {
+                return std::format(
+                    "error speed must be a power of two from {} to {}\n",
+                    static_cast<std::uint32_t>(MIN_SPEED),
+                    static_cast<std::uint32_t>(MAX_SPEED)
+                );
+            }
+            is_queued = sim.push({
+                .type = Command::Type::SetSpeed,
+                .speed = static_cast<std::uint8_t>(number)
+            });
+        } else if (name == "turbo") {
+            is_queued = sim.push({ .type = Command::Type::FastForward });
+        } else if (name == "normal") {
+            is_queued = sim.push({ .type = Command::Type::EndFastForward });
+        } else if (name == "run-to") {
+            if (!parse_number(argument, number) || number == 0) {
+                return "error run-to needs a generation\n";
+            }
+            is_queued = sim.push({ .type = Command::Type::FastForward, .gen = number });
+        } else if (name == "snapshot") {
+            is_queued = sim.push({ .type = Command::Type::Snapshot });
+        } else if (name == "metrics") {
+            return get_metrics();
+        } else if (name == "quit") {
+            is_quit_requested = true;
+            is_quit_requested.notify_all();
+        } else {
+            return std::format("error unknown command {}\n", name);
+        }
+        return is_queued ? "ok\n" : "error busy\n";
+    }
+    void serve() {
+        std::vector<Client> clients;
+        std::vector<pollfd> poll_fds;
+        for (;;) {
+            poll_fds.clear();
+            poll_fds.push_back({ .fd = wake_fds[0], .events = POLLIN, .revents = 0 });
+            poll_fds.push_back({ .fd = listen_fd, .events = POLLIN, .revents = 0 });
+            for (const Client &client : clients) {
+                poll_fds.push_back({ .fd = client.fd, .events = POLLIN, .revents = 0 });
+            }
+            if (poll(poll_fds.data(), poll_fds.size(), -1) == -1) {
+                continue;
+            }
+            if (poll_fds[0].revents) {
+                break;
+            }
+            // Clients are polled in the order they're kept, and dropped back to front
+            for (std::size_t i = clients.size(); i-- > 0;) {
+                if (!poll_fds[i + 2].revents) {
+                    continue;
+                }
+                Client &client = clients[i];
+                std::array<char, 1024> data;
+                const ssize_t received = recv(client.fd, data.data(), data.size(), 0);
+                bool is_open = received > 0;
+                if (is_open) {
+                    client.buffer.append(data.data(), received);
+                }
+                for (
+                    std::size_t end = client.buffer.find('\n');
+                    is_open && end != std::string::npos;
+                    end = client.buffer.find('\n')
+                ) {
+                    std::string_view line(client.buffer.data(), end);
+                    if (line.ends_with('\r')) {
+                        line.remove_suffix(1);
+                    }
+                    is_open = send_all(client.fd, handle(line));
+                    client.buffer.erase(0, end + 1);
+                }
+                if (!is_open || client.buffer.size() > CONTROL_MAX_LINE) {
+                    close(client.fd);
+                    clients.erase(clients.begin() + i);
+                }
+            }
+            if (poll_fds[1].revents) {
+                const std::int32_t fd = accept(listen_fd, nullptr, nullptr);
+                if (fd != -1) {
+                    clients.push_back({ .fd = fd, .buffer = {} });
+                }
+            }
+        }
+        for (const Client &client : clients) {
+            close(client.fd);
+        }
+    }
+public:
+    ControlServer() :
+        path{},
+        listen_fd{ -1 },
+        wake_fds{ -1, -1 },
+        is_quit_requested{ false },
+        thread{}
+    {}
+    ~ControlServer() {
+        stop();
+    }
+    // Replaces any socket left at the path by a previous run
+    bool start(const std::string &new_path) {
+        path = new_path;
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            return false;
+        }
+        std::ranges::copy(path, address.sun_path);
+        listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd == -1) {
+            return false;
+        }
+        unlink(path.c_str());
+        if (
+            bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1 ||
+            listen(listen_fd, 8) == -1 ||
+            pipe(wake_fds.data()) == -1
+        ) {
+            stop();
+            return false;
+        }
+        thread = std::jthread([this]() {
+            serve();
+        });
+        return true;
+    }
+    void wait_for_quit() {
+        is_quit_requested.wait(false);
+    }
+    void stop() noexcept {
+        if (thread.joinable()) {
+            const char wake = 0;
+            static_cast<void>(write(wake_fds[1], &wake, 1));
+            thread.join();
+        }
+        for (std::int32_t &fd : wake_fds) {
+            if (fd != -1) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (listen_fd != -1) {
+            close(listen_fd);
+            unlink(path.c_str());
+            listen_fd = -1;
+        }
+    }
+};
+
+// Runs one world without the window, driven over the control socket until told to quit
+bool run_controlled() {
+    std::error_code error;
+    const bool is_resuming =
+        !options.world_file.empty() && std::filesystem::exists(options.world_file, error);
+    if (is_resuming) {
+        if (!world.open(options.world_file)) {
+            return false;
+        }
+    } else {
+        world.rng.srand(options.seed.value_or(static_cast<std::uint32_t>(std::time(nullptr))));
+        if (
+            !world.create(options.world_w, options.world_h, options.huge_pages, options.world_file)
+        ) {
+            std::println(std::cerr, "[Control error] Couldn't create the world, try a smaller one");
+            return false;
+        }
+    }
+    if (!options.lineage_file.empty()) {
+        if (!lineage_log.open(options.lineage_file, is_resuming)) {
+            std::println(std::cerr, "[Lineage error] Couldn't open {}", options.lineage_file);
+            world.destroy();
+            return false;
+        }
+        world.lineage = &lineage_log;
+    }
+    if (!options.stream_name.empty()) {
+        if (!state_stream.open(options.stream_name, world.w, world.h)) {
+            std::println(std::cerr, "[Stream error] Couldn't create {}", options.stream_name);
+            world.destroy();
+            return false;
+        }
+        world.stream = &state_stream;
+    }
+    world.index = &chunk_index;
+    world.scheduler = &advance_scheduler;
+    if (is_resuming) {
+        chunk_index.rebuild(world);
+        if (world.stream) {
+            world.stream->publish(world);
+        }
+    } else {
+        std::atomic<std::uint32_t> tiles_generated{ 0 };
+        generate(world, std::stop_token{}, tiles_generated);
+    }
+    ControlServer server;
+    if (!server.start(options.control_socket)) {
+        std::println(std::cerr, "[Control error] Couldn't listen on {}", options.control_socket);
+        world.destroy();
+        return false;
+    }
+    std::println(
+        "Serving a world of {}x{} (seed {}) at generation {} on {}",
+        world.w,
+        world.h,
+        world.rng.seed,
+        world.gen,
+        options.control_socket
+    );
+    sim.start();
+    server.wait_for_quit();
+    server.stop();
+    sim.stop();
+    std::println("Stopped at generation {}", world.gen);
+    print_node_throughput();
+    world.destroy();
+    return true;
+}
+
+// Splits a world into columns and rows of domains, ranked column by column like tiles, with the
+// coordinator ranked after the last of them
+struct DomainGrid {
+    std::uint16_t cols, rows, w, h;
+    std::uint32_t get_coordinator() const noexcept {
+        return static_cast<std::uint32_t>(cols) * rows;
+    }
+    TileRegion get_interior(std::uint32_t rank) const noexcept {
+        const std::uint32_t col = rank / rows, row = rank % rows;
+        return {
+            static_cast<std::uint16_t>(col * w / cols),
+            static_cast<std::uint16_t>((col + 1) * w / cols),
+            static_cast<std::uint16_t>(row * h / rows),
+            static_cast<std::uint16_t>((row + 1) * h / rows)
+        };
+    }
+    TileRegion get_local(std::uint32_t rank) const noexcept {
+        return get_interior(rank).grow(DOMAIN_HALO, { 0, w, 0, h });
+    }
+    // Neighbors only share halos if no domain is narrower than a halo
+    bool is_valid() const noexcept {
+        return w / cols >= DOMAIN_HALO && h / rows >= DOMAIN_HALO;
+    }
+    // Every pair of processes that talk, the lower rank first: each domain with the domains
+    // below it and to its right, and with the coordinator
+    std::vector<std::array<std::uint32_t, 2>> get_links() const {
+        std::vector<std::array<std::uint32_t, 2>> links;
+        for (std::uint32_t rank = 0; rank < get_coordinator(); ++rank) {
+            if (rank % rows + 1u < rows) {
+                links.push_back({ rank, rank + 1 });
+            }
+            if (rank / rows + 1u < cols) {
+                links.push_back({ rank, rank + rows });
+            }
+            links.push_back({ rank, get_coordinator() });
+        }
+        return links;
+    }
+};
+
+constexpr std::uint32_t MAX_DOMAIN_LINKS = 5;
+
+// Moves messages between the processes of a domain grid. Both sides know how long each message
+// is, messages between two processes arrive in order, and sends may block until received.
+class DomainTransport {
+protected:
+    std::vector<std::array<std::uint32_t, 2>> links;
+    std::uint32_t rank;
+    std::vector<pid_t> worker_pids;
+    std::uint32_t find_link(std::uint32_t peer) const noexcept {
+        return static_cast<std::uint32_t>(std::ranges::find_if(links, [&](const auto &link) {
+            return
+                (link[0] == rank && link[1] == peer) ||
+                (link[0] == peer && link[1] == rank);
+        }) - links.begin());
+    }
+public:
+    DomainTransport(const DomainGrid &grid, std::uint32_t new_rank) :
+        links{ grid.get_links() },
+        rank{ new_rank },
+        worker_pids{}
+    {}
+    virtual ~DomainTransport() = default;
+    virtual bool send(std::uint32_t peer, const void *data, std::size_t size) = 0;
+    virtual bool receive(std::uint32_t peer, void *data, std::size_t size) = 0;
+    virtual void add_spawn_actions(std::uint32_t worker, posix_spawn_file_actions_t &actions) {
+        static_cast<void>(worker);
+        static_cast<void>(actions);
+    }
+    virtual void start(std::vector<pid_t> pids) {
+        worker_pids = std::move(pids);
+    }
+};
+
+#ifdef __linux__
+
+constexpr std::size_t DOMAIN_MAILBOX_SIZE = 1 << 16;
+
+constexpr std::chrono::seconds DOMAIN_WAIT_CHECK_INTERVAL{ 1 };
+
+struct DomainMailbox {
+    sem_t full, empty;
+    std::array<std::uint8_t, DOMAIN_MAILBOX_SIZE> data;
+};
+
+// Nobody posts for a process that died, so waits wake up now and then to check that the processes
+// they're waiting on are still there
+class SharedMemoryTransport : public DomainTransport {
+    std::string name;
+    DomainMailbox *mailboxes;
+    std::size_t mapping_size;
+    pid_t coordinator_pid;
+    DomainMailbox &get_mailbox(std::uint32_t peer, bool is_sending) noexcept {
+        const std::uint32_t link = find_link(peer);
+        return mailboxes[link * 2 + ((links[link][0] == rank) == is_sending ? 0 : 1)];
+    }
+    bool are_peers_alive() const noexcept {
+        if (coordinator_pid != getpid()) {
+            return getppid() == coordinator_pid;
+        }
+        for (const pid_t pid : worker_pids) {
+            siginfo_t info{};
+            if (
+                waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT) == 0 &&
+                info.si_pid == pid &&
+                (info.si_code != CLD_EXITED || info.si_status != 0)
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool wait(sem_t &semaphore) noexcept {
+        for (;;) {
+            timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += DOMAIN_WAIT_CHECK_INTERVAL.count();
+            if (sem_timedwait(&semaphore, &deadline) == 0) {
+                return true;
+            }
+            if ((errno != ETIMEDOUT && errno != EINTR) || !are_peers_alive()) {
+                return false;
+            }
+        }
+    }
+public:
+    SharedMemoryTransport(const DomainGrid &grid, std::uint32_t new_rank) :
+        DomainTransport(grid, new_rank),
+        name{},
+        mailboxes{ nullptr },
+        mapping_size{ sizeof(DomainMailbox) * 2 * links.size() },
+        coordinator_pid{ 0 }
+    {}
+    ~SharedMemoryTransport() override {
+        if (mailboxes) {
+            munmap(mailboxes, mapping_size);
+        }
+        if (coordinator_pid == getpid()) {
+            shm_unlink(name.c_str());
+        }
+    }
+    bool open() {
+        const bool is_coordinator = !options.domain_rank;
+        coordinator_pid = is_coordinator ? getpid() : getppid();
+        name = std::format("/{}-domains-{}", TITLE, coordinator_pid);
+        const std::int32_t fd = shm_open(
+            name.c_str(), is_coordinator ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600
+        );
+        if (fd == -1) {
+            coordinator_pid = 0;
+            return false;
+        }
+        void *ptr = !is_coordinator || ftruncate(fd, mapping_size) == 0 ?
+            mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) :
+            MAP_FAILED;
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            return false;
+        }
+        mailboxes = static_cast<DomainMailbox *>(ptr);
+        if (is_coordinator) {
+            for (std::size_t i = 0; i < links.size() * 2; ++i) {
+                sem_init(&mailboxes[i].full, 1, 0);
+                sem_init(&mailboxes[i].empty, 1, 1);
+            }
+        }
+        return true;
+    }
+    bool send(std::uint32_t peer, const void *data, std::size_t size) override {
+        DomainMailbox &mailbox = get_mailbox(peer, true);
+        const auto *bytes = static_cast<const std::uint8_t *>(data);
+        for (std::size_t offset = 0; offset < size; offset += DOMAIN_MAILBOX_SIZE) {
+            if (!wait(mailbox.empty)) {
+                return false;
+            }
+            std::copy_n(
+                bytes + offset, std::min(size - offset, DOMAIN_MAILBOX_SIZE), mailbox.data.data()
+            );
+            sem_post(&mailbox.full);
+        }
+        return true;
+    }
+    bool receive(std::uint32_t peer, void *data, std::size_t size) override {
+        DomainMailbox &mailbox = get_mailbox(peer, false);
+        auto *bytes = static_cast<std::uint8_t *>(data);
+        for (std::size_t offset = 0; offset < size; offset += DOMAIN_MAILBOX_SIZE) {
+            if (!wait(mailbox.full)) {
+                return false;
+            }
+            std::copy_n(
+                mailbox.data.data(), std::min(size - offset, DOMAIN_MAILBOX_SIZE), bytes + offset
+            );
+            sem_post(&mailbox.empty);
+        }
+        return true;
+    }
+};
+
+#endif
+
+// Workers get their ends as descriptors 3 and up in the order of their links
+class SocketTransport : public DomainTransport {
+    static constexpr std::int32_t FIRST_WORKER_FD = 3;
+    // Per link, the end of its first process and the end of its second, or -1 if not this one's
+    std::vector<std::array<std::int32_t, 2>> fds;
+    std::int32_t get_fd(std::uint32_t peer) const noexcept {
+        const std::uint32_t link = find_link(peer);
+        return fds[link][links[link][0] == rank ? 0 : 1];
+    }
+    void close_fds(bool is_keeping_own) noexcept {
+        for (std::size_t link = 0; link < links.size(); ++link) {
+            for (std::uint8_t side = 0; side < 2; ++side) {
+                std::int32_t &fd = fds[link][side];
+                if (fd != -1 && !(is_keeping_own && links[link][side] == rank)) {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+        }
+    }
+public:
+    SocketTransport(const DomainGrid &grid, std::uint32_t new_rank) :
+        DomainTransport(grid, new_rank),
+        fds(links.size(), { -1, -1 })
+    {}
+    ~SocketTransport() override {
+        close_fds(false);
+    }
+    // The coordinator keeps every end above the descriptors it hands out, so that handing them
+    // out never overwrites one still to hand out
+    bool open() {
+        if (options.domain_rank) {
+            std::int32_t fd = FIRST_WORKER_FD;
+            for (std::size_t link = 0; link < links.size(); ++link) {
+                for (std::uint8_t side = 0; side < 2; ++side) {
+                    if (links[link][side] == rank) {
+                        fds[link][side] = fd++;
+                    }
+                }
+            }
+            return true;
+        }
+        for (std::array<std::int32_t, 2> &link_fds : fds) {
+            std::array<std::int32_t, 2> pair;
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair.data()) == -1) {
+                return false;
+            }
+            for (std::uint8_t side = 0; side < 2; ++side) {
+                link_fds[side] =
+                    fcntl(pair[side], F_DUPFD_CLOEXEC, FIRST_WORKER_FD + MAX_DOMAIN_LINKS);
+                ::close(pair[side]);
+                if (link_fds[side] == -1) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    void add_spawn_actions(std::uint32_t worker, posix_spawn_file_actions_t &actions) override {
+        std::int32_t fd = FIRST_WORKER_FD;
+        for (std::size_t link = 0; link < links.size(); ++link) {
+            for (std::uint8_t side = 0; side < 2; ++side) {
+                if (links[link][side] == worker) {
+                    posix_spawn_file_actions_adddup2(&actions, fds[link][side], fd++);
+                }
+            }
+        }
+    }
+    // Only the coordinator's own ends stay open, so that it sees workers die
+    void start(std::vector<pid_t> pids) override {
+        DomainTransport::start(std::move(pids));
+        close_fds(true);
+    }
+    bool send(std::uint32_t peer, const void *data, std::size_t size) override {
+        const std::int32_t fd = get_fd(peer);
+        const auto *bytes = static_cast<const std::uint8_t *>(data);
+        while (size) {
+            const ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                if (sent == -1 && errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += sent;
+            size -= sent;
+        }
+        return true;
+    }
+    bool receive(std::uint32_t peer, void *data, std::size_t size) override {
+        const std::int32_t fd = get_fd(peer);
+        auto *bytes = static_cast<std::uint8_t *>(data);
+        while (size) {
+            const ssize_t received = recv(fd, bytes, size, 0);
+            if (received <= 0) {
+                if (received == -1 && errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += received;
+            size -= received;
+        }
+        return true;
+    }
+};
+
+std::unique_ptr<DomainTransport> open_domain_transport(
+    const DomainGrid &grid,
+    std::uint32_t rank
+) {
+    if (options.domain_transport == DomainTransportType::Socket) {
+        auto transport = std::make_unique<SocketTransport>(grid, rank);
+        return transport->open() ? std::move(transport) : nullptr;
+    }
+#ifdef __linux__
+    auto transport = std::make_unique<SharedMemoryTransport>(grid, rank);
+    return transport->open() ? std::move(transport) : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+struct DomainSetup {
+    std::uint32_t gen, seed, gens;
+    std::uint16_t w, h;
+};
+
+std::vector<Tile> pack_tiles(World &world, const TileRegion &region) {
+    std::vector<Tile> tiles;
+    tiles.reserve((region.x_end - region.x_begin) * (region.y_end - region.y_begin));
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        tiles.insert(tiles.end(), &world[x, region.y_begin], &world[x, region.y_end]);
+    }
+    return tiles;
+}
+
+void unpack_tiles(World &world, const TileRegion &region, const std::vector<Tile> &tiles) {
+    const std::uint16_t column_size = region.y_end - region.y_begin;
+    for (std::uint16_t x = region.x_begin; x < region.x_end; ++x) {
+        std::copy_n(
+            &tiles[(x - region.x_begin) * column_size], column_size, &world[x, region.y_begin]
+        );
+    }
+}
+
+bool send_tiles(DomainTransport &transport, std::uint32_t peer, const std::vector<Tile> &tiles) {
+    return transport.send(peer, tiles.data(), sizeof(Tile) * tiles.size());
+}
+
+bool receive_tiles(DomainTransport &transport, std::uint32_t peer, std::vector<Tile> &tiles) {
+    return transport.receive(peer, tiles.data(), sizeof(Tile) * tiles.size());
+}
+
+class Domain {
+    DomainGrid grid;
+    std::uint32_t rank;
+    DomainTransport &transport;
+    // The lower rank sends first
+    bool exchange(
+        World &world,
+        std::uint32_t neighbor,
+        const TileRegion &edge,
+        const TileRegion &halo
     ) {
-        cam_y = -(world.h * tile_h - ctx.window_h + y_bound) / 2;
-    } else if (cam_y > 0) {
-        cam_y = 0;
-    } else if (cam_y < -(world.h * tile_h - ctx.window_h + y_bound)) {
-        cam_y = -(world.h * tile_h - ctx.window_h + y_bound);
+        const std::vector<Tile> sent_tiles = pack_tiles(world, edge);
+        std::vector<Tile> received_tiles(sent_tiles.size());
+        const bool is_exchanged = rank < neighbor ?
+            send_tiles(transport, neighbor, sent_tiles) &&
+                receive_tiles(transport, neighbor, received_tiles) :
+            receive_tiles(transport, neighbor, received_tiles) &&
+                send_tiles(transport, neighbor, sent_tiles);
+        if (is_exchanged) {
+            unpack_tiles(world, halo, received_tiles);
+        }
+        return is_exchanged;
     }
-    SDL_Rect
-        srcrect{ .w = TILE_WIDTH, .h = TILE_HEIGHT },
-        dstrect{ .w = tile_w,     .h = tile_h      };
-    for (std::uint16_t x = 0; x < world.w; ++x) {
-        for (std::uint16_t y = 0; y < world.h; ++y) {
-            dstrect.x = static_cast<std::uint32_t>(x) * tile_w + cam_x;
-            dstrect.y = static_cast<std::uint32_t>(y) * tile_h + y_bound + cam_y;
+public:
+    bool is_failed;
+    Domain(const DomainGrid &new_grid, std::uint32_t new_rank, DomainTransport &new_transport) :
+        grid{ new_grid },
+        rank{ new_rank },
+        transport{ new_transport },
+        is_failed{ false }
+    {}
+    // Whole columns with the left and right neighbors first, then rows as wide as the halo with
+    // the neighbors above and below, which carries the corners over from the diagonal domains.
+    // Every exchange pairs a domain with one neighbor at a time, even columns or rows with the
+    // next one, then odd ones, so no cycle of domains ever waits on itself.
+    bool exchange_halo(World &world) {
+        const std::uint16_t
+            left = world.interior.x_begin,
+            right = world.interior.x_end,
+            top = world.interior.y_begin,
+            bottom = world.interior.y_end,
+            left_edge_end = left + DOMAIN_HALO,
+            right_edge_begin = right - DOMAIN_HALO,
+            top_edge_end = top + DOMAIN_HALO,
+            bottom_edge_begin = bottom - DOMAIN_HALO;
+        const std::uint32_t col = rank / grid.rows, row = rank % grid.rows;
+        for (std::uint8_t parity = 0; parity < 2; ++parity) {
             if (
-                dstrect.x + dstrect.w < 0 ||
-                dstrect.y + dstrect.h < y_bound ||
-                dstrect.x >= ctx.window_w ||
-                dstrect.y >= ctx.window_h
+                col % 2 == parity && col + 1u < grid.cols &&
+                !exchange(
+                    world,
+                    rank + grid.rows,
+                    { right_edge_begin, right, 0, world.h },
+                    { right, world.w, 0, world.h }
+                )
             ) {
-                continue;
+                return false;
             }
-            Tile &tile = world[x, y];
             if (
-                SDL_SetRenderDrawColor(
-                    ctx.renderer,
-                    COLOR_CUSTOM_QOL.r,
-                    COLOR_CUSTOM_QOL.g,
-                    COLOR_CUSTOM_QOL.b,
-                    0x02 * std::min(tile.energy, GENERATION_TILE_INIT_ENERGY_CAP + 1)
-                ) != 0 ||
-                SDL_RenderFillRect(ctx.renderer, &dstrect) != 0
+                col % 2 != parity && col > 0 &&
+                !exchange(
+                    world,
+                    rank - grid.rows,
+                    { left, left_edge_end, 0, world.h },
+                    { 0, left, 0, world.h }
+                )
             ) {
                 return false;
             }
-            select_still_frame(
-                srcrect,
-                Still::Tile
-            );
-            if (!ctx.render(srcrect, dstrect)) {
+        }
+        for (std::uint8_t parity = 0; parity < 2; ++parity) {
+            if (
+                row % 2 == parity && row + 1u < grid.rows &&
+                !exchange(
+                    world,
+                    rank + 1,
+                    { 0, world.w, bottom_edge_begin, bottom },
+                    { 0, world.w, bottom, world.h }
+                )
+            ) {
                 return false;
             }
-            if (animation_tick == 0) {
-                if (tile.cell.energy != 0) {
-                    select_still_frame(
-                        srcrect,
-                        Still::Cell
-                    );
-                    if (!ctx.render(srcrect, dstrect)) {
-                        return false;
-                    }
-                }
-            } else {
-                if (tile.active_evs.none() && tile.cell.energy != 0) {
-                    select_animation_frame(
-                        srcrect,
-                        Animation::Twitch,
-                        curr_tick - animation_tick,
-                        speed
-                    );
-                    if (!ctx.render(srcrect, dstrect)) {
-                        return false;
-                    }
-                }
-                for (std::uint8_t ev = 0; ev < Event::COUNT; ++ev) {
-                    if (tile.active_evs[ev]) {
-                        select_animation_frame(
-                            srcrect,
-                            ev + EVENT_TO_ANIMATION_OFFSET,
-                            curr_tick - animation_tick,
-                            speed
-                        );
-                        if (!ctx.render(srcrect, dstrect)) {
-                            return false;
-                        }
-                    }
-                }
+            if (
+                row % 2 != parity && row > 0 &&
+                !exchange(
+                    world, rank - 1, { 0, world.w, top, top_edge_end }, { 0, world.w, 0, top }
+                )
+            ) {
+                return false;
             }
         }
+        return true;
     }
-    if (
-        is_mouse_within_bounds &&
-        disp_x >= 0 &&
-        disp_y >= 0 &&
-        disp_x < world.w * tile_w &&
-        disp_y < world.h * tile_h
-    ) {
-        dstrect.x = disp_x / tile_w * tile_w + cam_x;
-        dstrect.y = disp_y / tile_h * tile_h + y_bound + cam_y;
+    // The coordinator hands out ids in scan order over the whole world: it gets how many cells
+    // were born in each interior column and answers with the last id given before each column
+    bool give_births(World &world, const std::vector<Birth> &births) {
+        const TileRegion &interior = world.interior;
+        const auto find_interior_column = [&](const Birth &birth) {
+            const std::uint16_t x = birth.child / world.h, y = birth.child % world.h;
+            if (
+                x < interior.x_begin || x >= interior.x_end ||
+                y < interior.y_begin || y >= interior.y_end
+            ) {
+                return std::optional<std::uint16_t>();
+            }
+            return std::optional<std::uint16_t>(x - interior.x_begin);
+        };
+        std::vector<std::uint32_t> counts(interior.x_end - interior.x_begin);
+        for (const Birth &birth : births) {
+            if (const std::optional<std::uint16_t> column = find_interior_column(birth)) {
+                ++counts[*column];
+            }
+        }
+        std::vector<std::uint64_t> last_ids(counts.size());
+        const std::uint32_t coordinator = grid.get_coordinator();
         if (
-            dstrect.x + dstrect.w >= 0 &&
-            dstrect.y + dstrect.h >= y_bound &&
-            dstrect.x < ctx.window_w &&
-            dstrect.y < ctx.window_h
+            !transport.send(coordinator, counts.data(), sizeof(std::uint32_t) * counts.size()) ||
+            !transport.receive(
+                coordinator, last_ids.data(), sizeof(std::uint64_t) * last_ids.size()
+            )
         ) {
-            select_still_frame(
-                srcrect,
-                Still::Cursor
-            );
-            if (!ctx.render(srcrect, dstrect)) {
-                return false;
+            return false;
+        }
+        std::optional<std::uint16_t> last_column;
+        for (const Birth &birth : births) {
+            const std::optional<std::uint16_t> column = find_interior_column(birth);
+            if (!column) {
+                continue;
+            }
+            if (column != last_column) {
+                world.next_cell_id = last_ids[*column];
+                last_column = column;
             }
+            world.give_birth(
+                world.tilemap[birth.child].cell, world.back_tilemap[birth.parent].cell.id
+            );
         }
-    }
-    if (!world.ptr) {
         return true;
     }
-    dstrect.x = world.get_ptr_x() * tile_w + cam_x;
-    dstrect.y = world.get_ptr_y() * tile_h + y_bound + cam_y;
+};
+
+void give_domain_births(World &world, const std::vector<Birth> &births) {
+    if (!world.domain->is_failed && !world.domain->give_births(world, births)) {
+        world.domain->is_failed = true;
+    }
+}
+
+bool run_domain_worker() {
+    const DomainGrid partial_grid{ .cols = options.domain_cols, .rows = options.domain_rows };
+    const std::uint32_t rank = *options.domain_rank, coordinator = partial_grid.get_coordinator();
+    std::unique_ptr<DomainTransport> transport = open_domain_transport(partial_grid, rank);
+    if (!transport) {
+        std::println(std::cerr, "[Domain error] Worker {} couldn't reach the coordinator", rank);
+        return false;
+    }
+    DomainSetup setup;
+    if (!transport->receive(coordinator, &setup, sizeof(setup))) {
+        return false;
+    }
+    DomainGrid grid = partial_grid;
+    grid.w = setup.w;
+    grid.h = setup.h;
+    const TileRegion local = grid.get_local(rank), interior = grid.get_interior(rank);
+    World domain_world{};
     if (
-        dstrect.x + dstrect.w >= 0 &&
-        dstrect.y + dstrect.h >= y_bound &&
-        dstrect.x < ctx.window_w &&
-        dstrect.y < ctx.window_h
+        !domain_world.create(
+            local.x_end - local.x_begin, local.y_end - local.y_begin, options.huge_pages, ""
+        )
     ) {
-        select_still_frame(
-            srcrect,
-            Still::Pointer
-        );
-        if (!ctx.render(srcrect, dstrect)) {
-            return false;
+        std::println(std::cerr, "[Domain error] Worker {} is out of memory", rank);
+        return false;
+    }
+    Domain domain(grid, rank, *transport);
+    domain_world.gen = setup.gen;
+    domain_world.rng.srand(setup.seed);
+    domain_world.origin_x = local.x_begin;
+    domain_world.origin_y = local.y_begin;
+    domain_world.full_h = grid.h;
+    domain_world.interior = {
+        static_cast<std::uint16_t>(interior.x_begin - local.x_begin),
+        static_cast<std::uint16_t>(interior.x_end - local.x_begin),
+        static_cast<std::uint16_t>(interior.y_begin - local.y_begin),
+        static_cast<std::uint16_t>(interior.y_end - local.y_begin)
+    };
+    domain_world.domain = &domain;
+    std::vector<Tile> tiles(domain_world.size);
+    bool is_done = receive_tiles(*transport, coordinator, tiles);
+    if (is_done) {
+        unpack_tiles(domain_world, domain_world.get_region(), tiles);
+        for (std::uint32_t gen = 0; is_done && gen < setup.gens; ++gen) {
+            advance(domain_world);
+            is_done = !domain.is_failed && domain.exchange_halo(domain_world);
         }
     }
-    return true;
+    is_done =
+        is_done &&
+        send_tiles(*transport, coordinator, pack_tiles(domain_world, domain_world.interior));
+    domain_world.destroy();
+    return is_done;
 }
 
-bool is_running = true;
-
-bool tick() {
-    SDL_GetWindowSize(ctx.window, &ctx.window_w, &ctx.window_h);
-    ctx.scroll_x = 0;
-    ctx.scroll_y = 0;
-    SDL_Event ev;
-    nk_input_begin(ctx.nk_ctx);
-    while (SDL_PollEvent(&ev)) {
-        switch (ev.type) {
-        case SDL_QUIT:
-            nk_input_end(ctx.nk_ctx);
-            is_running = false;
-            return true;
-        case SDL_MOUSEWHEEL:
-            ctx.scroll_x = ev.wheel.x;
-            ctx.scroll_y = ev.wheel.y;
+bool run_domains() {
+    std::error_code error;
+    const bool is_resuming =
+        !options.world_file.empty() && std::filesystem::exists(options.world_file, error);
+    if (is_resuming) {
+        if (!world.open(options.world_file)) {
+            return false;
+        }
+    } else {
+        world.rng.srand(options.seed.value_or(static_cast<std::uint32_t>(std::time(nullptr))));
+        if (
+            !world.create(options.world_w, options.world_h, options.huge_pages, options.world_file)
+        ) {
+            std::println(std::cerr, "[Domain error] Couldn't create the world, try a smaller one");
+            return false;
         }
-        nk_sdl_handle_event(&ev);
     }
-    nk_input_end(ctx.nk_ctx);
-    gui::render();
-    if (
-        SDL_SetRenderDrawColor(
-            ctx.renderer,
-            COLOR_BG.r,
-            COLOR_BG.g,
-            COLOR_BG.b,
-            COLOR_BG.a
-        ) != 0 ||
-        SDL_RenderClear(ctx.renderer) != 0
-    ) {
+    const DomainGrid grid{
+        .cols = options.domain_cols, .rows = options.domain_rows, .w = world.w, .h = world.h
+    };
+    if (!grid.is_valid()) {
+        std::println(
+            std::cerr,
+            "[Domain error] {}x{} domains of a {}x{} world would be narrower than their {}-tile "
+            "halos",
+            grid.cols,
+            grid.rows,
+            world.w,
+            world.h,
+            DOMAIN_HALO
+        );
+        world.destroy();
         return false;
     }
-    switch (active_ux_state) {
-    case UXState::Creation:
-        if (!ux_creation()) {
+    if (!is_resuming) {
+        std::atomic<std::uint32_t> tiles_generated{ 0 };
+        generate(world, std::stop_token{}, tiles_generated);
+    }
+    const std::uint32_t coordinator = grid.get_coordinator();
+    std::unique_ptr<DomainTransport> transport = open_domain_transport(grid, coordinator);
+    if (!transport) {
+        std::println(
+            std::cerr,
+            "[Domain error] Couldn't set up the {} transport",
+            DOMAIN_TRANSPORT_NAMES[std::to_underlying(options.domain_transport)]
+        );
+        world.destroy();
+        return false;
+    }
+    std::println(
+        "Running a world of {}x{} (seed {}) from generation {} for {} generations on {}x{} "
+        "domains over {}",
+        world.w,
+        world.h,
+        world.rng.seed,
+        world.gen,
+        options.ensemble_gens,
+        grid.cols,
+        grid.rows,
+        DOMAIN_TRANSPORT_NAMES[std::to_underlying(options.domain_transport)]
+    );
+    const auto start_time = std::chrono::steady_clock::now();
+    std::vector<pid_t> pids;
+    for (std::uint32_t rank = 0; rank < coordinator; ++rank) {
+        std::vector<std::string> worker_args = {
+            "--domain-worker", std::to_string(rank),
+            "--domains", std::format("{}x{}", grid.cols, grid.rows),
+            "--transport",
+            std::string(DOMAIN_TRANSPORT_NAMES[std::to_underlying(options.domain_transport)]),
+            "--huge-pages", std::string(HUGE_PAGES_NAMES[std::to_underlying(options.huge_pages)]),
+            "--update", std::string(UPDATE_MODE_NAMES[std::to_underlying(options.update_mode)]),
+            "--rng", std::string(RNG_DRAWS_NAMES[std::to_underlying(options.rng_draws)])
+        };
+        if (!options.rules_file.empty()) {
+            worker_args.push_back("--rules");
+            worker_args.push_back(std::filesystem::absolute(options.rules_file).string());
+        }
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        transport->add_spawn_actions(rank, actions);
+        const pid_t pid = spawn_worker(worker_args, &actions);
+        posix_spawn_file_actions_destroy(&actions);
+        if (pid == -1) {
+            std::println(std::cerr, "[Domain error] Couldn't start worker {}", rank);
+            break;
+        }
+        pids.push_back(pid);
+    }
+    transport->start(pids);
+    bool is_done = pids.size() == coordinator;
+    const DomainSetup setup{
+        .gen = world.gen,
+        .seed = world.rng.seed,
+        .gens = options.ensemble_gens,
+        .w = world.w,
+        .h = world.h
+    };
+    for (std::uint32_t rank = 0; is_done && rank < coordinator; ++rank) {
+        is_done =
+            transport->send(rank, &setup, sizeof(setup)) &&
+            send_tiles(*transport, rank, pack_tiles(world, grid.get_local(rank)));
+    }
+    // Births of a column of the world come from the column of domains it's in, top to bottom
+    std::vector<std::vector<std::uint32_t>> counts(coordinator);
+    std::vector<std::vector<std::uint64_t>> last_ids(coordinator);
+    for (std::uint32_t rank = 0; rank < coordinator; ++rank) {
+        const TileRegion interior = grid.get_interior(rank);
+        counts[rank].resize(interior.x_end - interior.x_begin);
+        last_ids[rank].resize(interior.x_end - interior.x_begin);
+    }
+    for (std::uint32_t gen = 0; is_done && gen < options.ensemble_gens; ++gen) {
+        for (std::uint32_t rank = 0; is_done && rank < coordinator; ++rank) {
+            is_done = transport->receive(
+                rank, counts[rank].data(), sizeof(std::uint32_t) * counts[rank].size()
+            );
+        }
+        for (std::uint32_t rank = 0; is_done && rank < coordinator; ++rank) {
+            if (rank % grid.rows != 0) {
+                continue;
+            }
+            for (std::size_t column = 0; column < counts[rank].size(); ++column) {
+                for (std::uint32_t row = 0; row < grid.rows; ++row) {
+                    last_ids[rank + row][column] = world.next_cell_id;
+                    world.next_cell_id += counts[rank + row][column];
+                }
+            }
+        }
+        for (std::uint32_t rank = 0; is_done && rank < coordinator; ++rank) {
+            is_done = transport->send(
+                rank, last_ids[rank].data(), sizeof(std::uint64_t) * last_ids[rank].size()
+            );
+        }
+    }
+    // The world only changes from here on, and a world file stays unresumable until it's whole
+    if (is_done) {
+        world.begin_update();
+    }
+    for (std::uint32_t rank = 0; is_done && rank < coordinator; ++rank) {
+        const TileRegion interior = grid.get_interior(rank);
+        std::vector<Tile> tiles(
+            (interior.x_end - interior.x_begin) * (interior.y_end - interior.y_begin)
+        );
+        is_done = receive_tiles(*transport, rank, tiles);
+        if (is_done) {
+            unpack_tiles(world, interior, tiles);
+        }
+    }
+    for (const pid_t pid : pids) {
+        if (!is_done) {
+            kill(pid, SIGTERM);
+        }
+        std::int32_t status;
+        const bool is_exited = waitpid(pid, &status, 0) == pid;
+        is_done = is_done && is_exited && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    if (!is_done) {
+        std::println(std::cerr, "[Domain error] A worker failed");
+        world.destroy();
+        return false;
+    }
+    world.gen += options.ensemble_gens;
+    world.end_update();
+    std::println(
+        "Done in {:.3f} s at generation {} with {} live cells",
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count(),
+        world.gen,
+        count_live_cells(world)
+    );
+    world.destroy();
+    return true;
+}
+
+#else
+
+void give_domain_births(World &, const std::vector<Birth> &) {}
+
+#endif
+
+bool parse_options(std::int32_t argc, char *argv[]) {
+    for (std::int32_t i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--help") {
+            std::println(
+                "Usage: {} [options]\n"
+                "  --huge-pages <off|transparent|explicit>  "
+                "back the world with 2 MB pages (default: transparent)\n"
+                "  --update <sequential|synchronous>        "
+                "update tiles in scan order or all at once (default: sequential)\n"
+                "  --numa <off|partition>                   "
+                "split synchronous updates across NUMA nodes (default: off)\n"
+                "  --rng <compat|fast>                      "
+                "bound random draws by remainder or multiply-shift (default: compat)\n"
+                "  --world-file <path>                      "
+                "back the world with a file, resuming it if it exists\n"
+                "  --rules <path>                           "
+                "load rule parameters from a config file\n"
+                "  --ensemble <runs>                        "
+                "run worlds headless and write per-generation stats\n"
+                "  --gens <count>                           "
+                "generations per ensemble run or frame export (default: 1000)\n"
+                "  --size <w>x<h>                           "
+                "ensemble or frame export world size (default: 256x256)\n"
+                "  --seed <seed>                            "
+                "seed of the first ensemble run (default: time)\n"
+                "  --threads <count>                        "
+                "ensemble, frame encoder or synchronous update threads (default: all cores)\n"
+                "  --stats <path>                           "
+                "ensemble stats CSV (default: stats.csv)\n"
+                "  --stats-interval <count>                 "
+                "generations between stats rows (default: 1, last only in sweeps)\n"
+                "  --sweep <spec>                           "
+                "run the rule grid in the spec on worker processes\n"
+                "  --sweep-dir <path>                       "
+                "sweep queue and results, resumed if present (default: sweep)\n"
+                "  --workers <count>                        "
+                "sweep worker processes (default: all cores)\n"
+                "  --seeds <count>                          "
+                "seeds per sweep point (default: 8)\n"
+                "  --lineage <path>                         "
+                "log cell births, deaths and evolutions (per seed in ensembles)\n"
+                "  --lineage-query <path>                   "
+                "summarize a lineage log, or with --ancestors <id> or\n"
+                "                                           "
+                "--descendants <id> trace one cell\n"
+                "  --frames <dir>                           "
+                "run one world headless and write its frames as PNGs\n"
+                "  --frame-interval <count>                 "
+                "generations between frames (default: 1)\n"
+                "  --frame-tile <px>                        "
+                "frame pixels per tile (default: 4)\n"
+                "  --encoders <count>                       "
+                "frame encoder threads, taken from --threads if synchronous (default: half)\n"
+                "  --record <path>                          "
+                "record the sim view as a GIF, or raw RGB24 video otherwise\n"
+                "  --stream <name>                          "
+                "publish every generation to POSIX shared memory\n"
+                "  --control <path>                         "
+                "run without the window, controlled over a Unix socket\n"
+                "  --domains <cols>x<rows>                  "
+                "split a synchronous world over worker processes\n"
+                "  --transport <shm|socket>                 "
+                "how domain workers talk (default: shm)",
+                TITLE
+            );
             return false;
         }
-        break;
-    case UXState::Generation:
-        if (!ux_generation()) {
+        if (i + 1 >= argc) {
+            std::println(std::cerr, "[Option error] Missing value for {}", arg);
             return false;
         }
-        break;
-    case UXState::Sim:
-        if (!ux_sim()) {
+        const std::string_view value = argv[++i];
+        if (arg == "--huge-pages") {
+            const auto name = std::ranges::find(HUGE_PAGES_NAMES, value);
+            if (name == HUGE_PAGES_NAMES.end()) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            options.huge_pages =
+                static_cast<HugePages>(std::distance(HUGE_PAGES_NAMES.begin(), name));
+        } else if (arg == "--update") {
+            const auto name = std::ranges::find(UPDATE_MODE_NAMES, value);
+            if (name == UPDATE_MODE_NAMES.end()) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            options.update_mode =
+                static_cast<UpdateMode>(std::distance(UPDATE_MODE_NAMES.begin(), name));
+        } else if (arg == "--numa") {
+            const auto name = std::ranges::find(NUMA_PLACEMENT_NAMES, value);
+            if (name == NUMA_PLACEMENT_NAMES.end()) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            options.numa_placement =
+                static_cast<NumaPlacement>(std::distance(NUMA_PLACEMENT_NAMES.begin(), name));
+        } else if (arg == "--rng") {
+            const auto name = std::ranges::find(RNG_DRAWS_NAMES, value);
+            if (name == RNG_DRAWS_NAMES.end()) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            options.rng_draws =
+                static_cast<RngDraws>(std::distance(RNG_DRAWS_NAMES.begin(), name));
+        } else if (arg == "--transport") {
+            const auto name = std::ranges::find(DOMAIN_TRANSPORT_NAMES, value);
+            if (name == DOMAIN_TRANSPORT_NAMES.end()) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            options.domain_transport = static_cast<DomainTransportType>(
+                std::distance(DOMAIN_TRANSPORT_NAMES.begin(), name)
+            );
+        } else if (arg == "--world-file") {
+            options.world_file = value;
+        } else if (arg == "--rules") {
+            options.rules_file = value;
+        } else if (
+            arg == "--ensemble" ||
+            arg == "--gens" ||
+            arg == "--threads" ||
+            arg == "--workers" ||
+            arg == "--seeds" ||
+            arg == "--frame-interval" ||
+            arg == "--frame-tile" ||
+            arg == "--encoders"
+        ) {
+            std::uint32_t &number =
+                arg == "--ensemble" ? options.ensemble_runs :
+                arg == "--gens" ? options.ensemble_gens :
+                arg == "--seeds" ? options.sweep_seeds :
+                arg == "--frame-interval" ? options.frame_interval :
+                arg == "--frame-tile" ? options.frame_tile :
+                arg == "--encoders" ? options.encoder_threads : options.threads;
+            if (
+                !parse_number(value, number) ||
+                ((arg == "--frame-interval" || arg == "--frame-tile") && number == 0)
+            ) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+        } else if (arg == "--stats") {
+            options.stats_file = value;
+        } else if (arg == "--frames") {
+            options.frames_dir = value;
+        } else if (arg == "--record") {
+            options.record_file = value;
+        } else if (arg == "--stream") {
+            options.stream_name = value;
+        } else if (arg == "--control") {
+            options.control_socket = value;
+        } else if (arg == "--seed" || arg == "--stats-interval") {
+            std::uint32_t number;
+            if (!parse_number(value, number) || (arg == "--stats-interval" && number == 0)) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            (arg == "--seed" ? options.seed : options.stats_interval) = number;
+        } else if (arg == "--lineage") {
+            options.lineage_file = value;
+        } else if (arg == "--lineage-query") {
+            options.lineage_query_file = value;
+        } else if (arg == "--ancestors" || arg == "--descendants") {
+            std::uint64_t id;
+            if (!parse_number(value, id)) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            (arg == "--ancestors" ? options.ancestors_of : options.descendants_of) = id;
+        } else if (arg == "--sweep") {
+            options.sweep_file = value;
+        } else if (arg == "--sweep-dir" || arg == "--sweep-worker") {
+            options.sweep_dir = value;
+            options.is_sweep_worker = arg == "--sweep-worker";
+        } else if (arg == "--domain-worker") {
+            std::uint32_t rank;
+            if (!parse_number(value, rank)) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+            options.domain_rank = rank;
+        } else if (arg == "--domains") {
+            const std::size_t separator = value.find('x');
+            if (
+                separator == std::string_view::npos ||
+                !parse_number(value.substr(0, separator), options.domain_cols) ||
+                !parse_number(value.substr(separator + 1), options.domain_rows) ||
+                options.domain_cols == 0 ||
+                options.domain_rows == 0
+            ) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+        } else if (arg == "--size") {
+            const std::size_t separator = value.find('x');
+            if (
+                separator == std::string_view::npos ||
+                !parse_number(value.substr(0, separator), options.world_w) ||
+                !parse_number(value.substr(separator + 1), options.world_h) ||
+                options.world_w < 10 ||
+                options.world_h < 10
+            ) {
+                std::println(std::cerr, "[Option error] Invalid value for {}: {}", arg, value);
+                return false;
+            }
+        } else {
+            std::println(std::cerr, "[Option error] Unknown option: {}", arg);
             return false;
         }
-        break;
-    default:
+    }
+    if (
+        options.numa_placement != NumaPlacement::Off &&
+        options.update_mode != UpdateMode::Synchronous
+    ) {
+        std::println(std::cerr, "[Option error] --numa needs --update synchronous");
+        return false;
+    }
+    if (options.domain_cols && options.update_mode != UpdateMode::Synchronous) {
+        std::println(std::cerr, "[Option error] --domains needs --update synchronous");
+        return false;
+    }
+    if (options.domain_cols && (!options.lineage_file.empty() || !options.stream_name.empty())) {
+        std::println(std::cerr, "[Option error] --domains doesn't support --lineage or --stream");
         return false;
     }
-    nk_sdl_render(NK_ANTI_ALIASING_ON);
-    SDL_RenderPresent(ctx.renderer);
     return true;
 }
 
-int main(int, char *[]) {
-    std::println("{} {} - {}", TITLE, VERSION, RELEASE_DATE);
+int main(int argc, char *argv[]) {
+    options.executable = argv[0];
+    if (!parse_options(argc, argv)) {
+        return 1;
+    }
+    if (!options.is_sweep_worker && !options.domain_rank) {
+        std::println("{} {} - {}", TITLE, VERSION, RELEASE_DATE);
+    }
+    if (!options.rules_file.empty() && !load_rules(options.rules_file)) {
+        return 1;
+    }
+    select_advance_passes();
+    if (!options.lineage_query_file.empty()) {
+        return run_lineage_query() ? 0 : 1;
+    }
+    if (!options.sweep_file.empty() || options.is_sweep_worker) {
+#ifdef _WIN32
+        std::println(std::cerr, "[Sweep error] Sweeps aren't supported on Windows yet");
+        return 1;
+#else
+        return (options.is_sweep_worker ? run_sweep_worker() : run_sweep()) ? 0 : 1;
+#endif
+    }
+    if (options.domain_cols) {
+#ifdef _WIN32
+        std::println(std::cerr, "[Domain error] Domains aren't supported on Windows yet");
+        return 1;
+#else
+        return (options.domain_rank ? run_domain_worker() : run_domains()) ? 0 : 1;
+#endif
+    }
+#ifdef _WIN32
+    if (!options.stream_name.empty()) {
+        std::println(std::cerr, "[Stream error] State streams aren't supported on Windows yet");
+        return 1;
+    }
+    if (!options.control_socket.empty()) {
+        std::println(std::cerr, "[Control error] Control sockets aren't supported on Windows yet");
+        return 1;
+    }
+#endif
+    if (options.ensemble_runs) {
+        return run_ensemble() ? 0 : 1;
+    }
+    if (!options.frames_dir.empty()) {
+        return run_frame_export() ? 0 : 1;
+    }
+#ifndef _WIN32
+    if (!options.control_socket.empty()) {
+        return run_controlled() ? 0 : 1;
+    }
+#endif
+    std::error_code error;
+    if (!options.world_file.empty() && std::filesystem::exists(options.world_file, error)) {
+        if (!world.open(options.world_file)) {
+            return 1;
+        }
+        if (!options.lineage_file.empty()) {
+            if (!lineage_log.open(options.lineage_file, true)) {
+                std::println(std::cerr, "[Lineage error] Couldn't open {}", options.lineage_file);
+                return 1;
+            }
+            world.lineage = &lineage_log;
+        }
+        if (!options.stream_name.empty()) {
+            if (!state_stream.open(options.stream_name, world.w, world.h)) {
+                std::println(std::cerr, "[Stream error] Couldn't create {}", options.stream_name);
+                return 1;
+            }
+            world.stream = &state_stream;
+            state_stream.publish(world);
+        }
+        world.index = &chunk_index;
+        world.scheduler = &advance_scheduler;
+        chunk_index.rebuild(world);
+        active_ux_state = UXState::Sim;
+    }
     try {
-        if (!ctx) {
+        if (!ctx.init()) {
             std::println(std::cerr, "[SDL error] {}", SDL_GetError());
             return 1;
         }
@@ -2002,6 +9039,7 @@ int main(int, char *[]) {
                 return 1;
             }
         }
+        stop_recording();
     } catch (const std::exception &exception) {
         std::println(std::cerr, "[C++ exception] {}", exception.what());
         return 1;